@@ -0,0 +1,1510 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "maddy/blockcache.h"
+#include "maddy/blockclassifier.h"
+#include "maddy/contenthash.h"
+#include "maddy/documentoutline.h"
+#include "maddy/documentplan.h"
+#include "maddy/documenttree.h"
+#include "maddy/htmlescape.h"
+#include "maddy/outputsink.h"
+#include "maddy/parserbudget.h"
+#include "maddy/parserconfig.h"
+#include "maddy/parserfeatures.h"
+
+// BlockParser
+#include "maddy/checklistparser.h"
+#include "maddy/codeblockparser.h"
+#include "maddy/headlineparser.h"
+#include "maddy/horizontallineparser.h"
+#include "maddy/htmlparser.h"
+#include "maddy/latexblockparser.h"
+#include "maddy/orderedlistparser.h"
+#include "maddy/paragraphparser.h"
+#include "maddy/pipetableparser.h"
+#include "maddy/quoteparser.h"
+#include "maddy/tableparser.h"
+#include "maddy/unorderedlistparser.h"
+
+// LineParser
+#include "maddy/inlineparser.h"
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * ParserSession
+ *
+ * The state of one document, which is parsed line by line.
+ *
+ * @class
+ */
+class ParserSession
+{
+public:
+  /**
+   * dtor
+   *
+   * @method
+   */
+  virtual ~ParserSession() {}
+
+  /**
+   * AddLine
+   *
+   * Adds the next line (without the line break) of the document.
+   *
+   * @method
+   * @param {std::string&} line
+   * @return {void}
+   */
+  virtual void AddLine(std::string& line) = 0;
+
+  /**
+   * HasOpenBlock
+   *
+   * Checks if a block was started, which is not finished yet. Between two
+   * blocks the next line starts in the same state as a new document.
+   *
+   * @method
+   * @return {bool}
+   */
+  virtual bool HasOpenBlock() const = 0;
+
+  /**
+   * Finish
+   *
+   * Closes all open blocks. Afterwards the session can be used for the next
+   * document.
+   *
+   * @method
+   * @return {void}
+   */
+  virtual void Finish() = 0;
+}; // class ParserSession
+
+// -----------------------------------------------------------------------------
+
+/**
+ * BasicParser
+ *
+ * Transforms Markdown to HTML
+ *
+ * The enabled parsers are given by the `Features` type, either
+ * `RuntimeParserFeatures` (read from a `ParserConfig`) or
+ * `StaticParserFeatures` (fixed at compile time). With a static feature set
+ * every check for a parser type is a constant, so disabled parsers are
+ * compiled out and all line parsers are called directly.
+ *
+ * The `ParserLimits` are the resource budget of every parse. Lines, which
+ * exceed it, are written as escaped plain text instead of being parsed.
+ * Once the output limit is reached, the rest of the document is dropped.
+ *
+ * Buffers are scanned once for a `DocumentPlan` before parsing, so parsers
+ * of features, which the document does not use, are not even tried. Streams
+ * and sessions try all enabled parsers.
+ *
+ * @class
+ */
+template <class Features>
+class BasicParser
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   * @param {Features} features
+   * @param {ParserLimits} limits
+   */
+  explicit BasicParser(
+    Features features = Features(), ParserLimits limits = ParserLimits()
+  )
+    : features(features)
+    , limits(limits)
+  {}
+
+  /**
+   * Parse
+   *
+   * @method
+   * @param {const std::istream&} markdown
+   * @return {std::string} HTML
+   */
+  std::string Parse(std::istream& markdown) const
+  {
+    std::string result = "";
+    StringOutputSink sink(result);
+
+    this->Parse(markdown, sink);
+
+    return result;
+  }
+
+  /**
+   * Parse
+   *
+   * Writes every finished block directly into the given sink.
+   *
+   * @method
+   * @param {const std::istream&} markdown
+   * @param {OutputSink&} sink
+   * @return {void}
+   */
+  void Parse(std::istream& markdown, OutputSink& sink) const
+  {
+    Session session(*this, sink);
+
+    for (std::string line; std::getline(markdown, line);)
+    {
+      session.AddLine(line);
+    }
+
+    session.Finish();
+  }
+
+  /**
+   * Parse
+   *
+   * Parses a contiguous buffer without copying it into a stream first. Lines
+   * are split at `\n` the same way `std::getline` does it, so the result is
+   * identical to the `std::istream` overload. Each line is only materialized
+   * in one reused line buffer, because the block parsers rewrite it in place.
+   *
+   * @method
+   * @param {const char*} markdown
+   * @param {size_t} size
+   * @return {std::string} HTML
+   */
+  std::string Parse(const char* markdown, size_t size) const
+  {
+    std::string result = "";
+    StringOutputSink sink(result);
+
+    this->Parse(markdown, size, sink);
+
+    return result;
+  }
+
+  /**
+   * Parse
+   *
+   * Writes every finished block directly into the given sink.
+   *
+   * @method
+   * @param {const char*} markdown
+   * @param {size_t} size
+   * @param {OutputSink&} sink
+   * @return {void}
+   */
+  void Parse(const char* markdown, size_t size, OutputSink& sink) const
+  {
+    Session session(*this, sink, DocumentPlan::Scan(markdown, size));
+
+    addLines(session, markdown, markdown + size);
+    session.Finish();
+  }
+
+  /**
+   * ParseParallel
+   *
+   * Parses a large buffer on several threads with exactly the same output as
+   * `Parse`.
+   *
+   * A pre-scan splits the document at blank lines, which are outside of
+   * code, LaTeX and HTML blocks, into chunks of about `chunkSize` bytes. The
+   * chunks are parsed in parallel, each one as if it was the start of a
+   * document. Afterwards every chunk is checked in order: if the previous
+   * chunk left a block open (e.g. a quote containing a code block), the split
+   * was not safe and the chunk is parsed again as continuation of the
+   * previous one. So the pre-scan only has to be right most of the time.
+   *
+   * @method
+   * @param {const char*} markdown
+   * @param {size_t} size
+   * @param {OutputSink&} sink
+   * @param {size_t} threadCount
+   * @param {size_t} chunkSize
+   * @return {void}
+   */
+  void ParseParallel(
+    const char* markdown,
+    size_t size,
+    OutputSink& sink,
+    size_t threadCount,
+    size_t chunkSize
+  ) const
+  {
+    const std::vector<const char*> splitPoints =
+      findSplitPoints(markdown, size, chunkSize);
+
+    if (threadCount < 2 || splitPoints.size() < 3)
+    {
+      this->Parse(markdown, size, sink);
+      return;
+    }
+
+    // the plan of the whole document also holds for every chunk
+    const DocumentPlan plan = DocumentPlan::Scan(markdown, size);
+    std::vector<std::unique_ptr<Chunk>> chunks;
+
+    for (size_t i = 0; i + 1 < splitPoints.size(); ++i)
+    {
+      chunks.emplace_back(
+        new Chunk(*this, plan, splitPoints[i], splitPoints[i + 1])
+      );
+    }
+
+    std::atomic<size_t> nextChunk(0);
+    auto parseChunks = [&chunks, &nextChunk]()
+    {
+      for (size_t i = nextChunk++; i < chunks.size(); i = nextChunk++)
+      {
+        Chunk& chunk = *chunks[i];
+
+        try
+        {
+          addLines(chunk.session, chunk.begin, chunk.end);
+        }
+        catch (...)
+        {
+          chunk.error = std::current_exception();
+        }
+      }
+    };
+
+    std::vector<std::thread> workers;
+    threadCount = std::min(threadCount, chunks.size());
+
+    for (size_t i = 1; i < threadCount; ++i)
+    {
+      workers.emplace_back(parseChunks);
+    }
+
+    parseChunks();
+
+    for (std::thread& worker : workers)
+    {
+      worker.join();
+    }
+
+    // the chunk, whose session is continued by the following chunks
+    Chunk* current = chunks[0].get();
+
+    for (size_t i = 1; i < chunks.size(); ++i)
+    {
+      if (current->error)
+      {
+        std::rethrow_exception(current->error);
+      }
+
+      if (current->session.HasOpenBlock())
+      {
+        addLines(current->session, chunks[i]->begin, chunks[i]->end);
+        continue;
+      }
+
+      current->WriteTo(sink);
+      current = chunks[i].get();
+    }
+
+    if (current->error)
+    {
+      std::rethrow_exception(current->error);
+    }
+
+    current->session.Finish();
+    current->WriteTo(sink);
+  }
+
+  /**
+   * Parse
+   *
+   * @method
+   * @param {const std::string&} markdown
+   * @return {std::string} HTML
+   */
+  std::string Parse(const std::string& markdown) const
+  {
+    return this->Parse(markdown.data(), markdown.size());
+  }
+
+  /**
+   * Parse
+   *
+   * @method
+   * @param {const std::string&} markdown
+   * @param {OutputSink&} sink
+   * @return {void}
+   */
+  void Parse(const std::string& markdown, OutputSink& sink) const
+  {
+    this->Parse(markdown.data(), markdown.size(), sink);
+  }
+
+  /**
+   * ParseCached
+   *
+   * Parses the buffer like `Parse`, but reuses the HTML of blocks, which are
+   * in the cache.
+   *
+   * The document is cut at blank lines outside of code, LaTeX and HTML
+   * blocks (see `findSplitPoints`). A part between two such lines starts
+   * without an open block, so its HTML only depends on its source and the
+   * parser settings, given by `settingsKey`. If a part leaves a block open,
+   * it is parsed together with the next ones, until no block is open any
+   * more, and cached as a whole.
+   *
+   * @method
+   * @param {const char*} markdown
+   * @param {size_t} size
+   * @param {OutputSink&} sink
+   * @param {BlockCache&} cache
+   * @param {uint64_t} settingsKey
+   * @return {void}
+   */
+  void ParseCached(
+    const char* markdown,
+    size_t size,
+    OutputSink& sink,
+    BlockCache& cache,
+    uint64_t settingsKey
+  ) const
+  {
+    const std::vector<const char*> splitPoints =
+      findSplitPoints(markdown, size, 1);
+    const char* documentEnd = markdown + size;
+    std::string html;
+    StringOutputSink partSink(html);
+    Session session(*this, partSink, DocumentPlan::Scan(markdown, size));
+    size_t i = 0;
+
+    while (i + 1 < splitPoints.size())
+    {
+      const char* begin = splitPoints[i];
+      const char* end = splitPoints[i + 1];
+      const size_t partSize = static_cast<size_t>(end - begin);
+
+      if (partSize >= MIN_CACHED_SIZE &&
+          cache.Find(
+            getPartKey(begin, end, documentEnd, settingsKey), partSize, html
+          ))
+      {
+        writeHtml(sink, html);
+        ++i;
+        continue;
+      }
+
+      addLines(session, begin, end);
+      ++i;
+
+      while (session.HasOpenBlock() && i + 1 < splitPoints.size())
+      {
+        end = splitPoints[i + 1];
+        addLines(session, splitPoints[i], end);
+        ++i;
+      }
+
+      // a used up budget depends on more than the source
+      const bool isCacheable = !session.IsBudgetExhausted();
+
+      if (end == documentEnd)
+      {
+        session.Finish();
+      }
+
+      if (isCacheable && static_cast<size_t>(end - begin) >= MIN_CACHED_SIZE)
+      {
+        cache.Insert(
+          getPartKey(begin, end, documentEnd, settingsKey),
+          static_cast<size_t>(end - begin),
+          html
+        );
+      }
+
+      writeHtml(sink, html);
+    }
+  }
+
+  /**
+   * ParseTree
+   *
+   * Parses the Markdown into a `DocumentTree` instead of writing the HTML
+   * into a sink. Only the blocks are parsed, the line parsers and the syntax
+   * highlighting run when the tree is rendered. With a `maxOutputSize` the
+   * budget depends on the whole HTML, so then they run here as well.
+   *
+   * @method
+   * @param {const char*} markdown
+   * @param {size_t} size
+   * @param {DocumentTree&} tree
+   * @return {bool} false and an empty tree, if the Markdown does not fit the
+   * 32 bit offsets of the tree
+   */
+  bool ParseTree(const char* markdown, size_t size, DocumentTree& tree) const
+  {
+    if (size > DocumentTree::MAX_SOURCE_SIZE)
+    {
+      tree.Clear();
+      return false;
+    }
+
+    const DocumentPlan plan = DocumentPlan::Scan(markdown, size);
+    DocumentTreeBuilder builder(tree, plan);
+    Session session(
+      *this,
+      builder,
+      this->limits.maxOutputSize == 0 ? plan.WithoutHtmlOnlyParsers() : plan,
+      &builder
+    );
+    std::string line;
+    const char* current = markdown;
+    const char* end = markdown + size;
+
+    while (current < end)
+    {
+      const char* lineEnd = static_cast<const char*>(
+        std::memchr(current, '\n', static_cast<size_t>(end - current))
+      );
+
+      if (!lineEnd)
+      {
+        lineEnd = end;
+      }
+
+      builder.BeginLine(
+        static_cast<size_t>(current - markdown),
+        static_cast<size_t>(lineEnd - current)
+      );
+      line.assign(current, lineEnd);
+      session.AddLine(line);
+      builder.EndLine();
+      current = lineEnd + 1;
+
+      // the same fast path as `Parse`, so that the budget is used the same way
+      const char* next =
+        current < end ? session.AddVerbatimLines(current, end) : current;
+
+      if (next != current)
+      {
+        builder.BeginLine(
+          static_cast<size_t>(current - markdown),
+          static_cast<size_t>(next - 1 - current)
+        );
+        builder.EndLine();
+        current = next;
+      }
+    }
+
+    // the empty line, which `Finish` adds to an open block
+    builder.BeginLine(size, 0);
+    session.Finish();
+
+    return true;
+  }
+
+  /**
+   * RenderTree
+   *
+   * Writes the HTML of a `DocumentTree`, which was parsed from `markdown`
+   * with the same settings. Every top-level block is rendered by the block
+   * parser of its node type from its source range, nested blocks and the
+   * inline markup are rendered by that parser. So the HTML is the same as
+   * the one of `Parse`.
+   *
+   * @method
+   * @param {const char*} markdown
+   * @param {const DocumentTree&} tree
+   * @param {OutputSink&} sink
+   * @return {void}
+   */
+  void RenderTree(
+    const char* markdown, const DocumentTree& tree, OutputSink& sink
+  ) const
+  {
+    const std::vector<DocumentNode>& nodes = tree.GetNodes();
+
+    if (nodes.empty())
+    {
+      return;
+    }
+
+    BlockParserPool pool(*this, tree.GetPlan(), nullptr, nullptr);
+    std::string line;
+
+    for (uint32_t i = nodes[0].firstChild; i != DocumentTree::NO_NODE;
+         i = nodes[i].nextSibling)
+    {
+      const DocumentNode& node = nodes[i];
+
+      if (node.kind == DocumentNode::TEXT_NODE)
+      {
+        line.clear();
+        appendTextLine(line, markdown, node);
+        sink.Write(line.data(), line.size());
+        continue;
+      }
+
+      BlockParser* blockParser = pool.StartBlock(
+        getBlockParserOfType(node.blockType, pool.GetLevel(0)),
+        node.blockType,
+        0
+      );
+
+      if (!blockParser)
+      {
+        continue;
+      }
+
+      renderBlock(*blockParser, markdown, nodes, node);
+
+      const OutputBuffer& blockResult = blockParser->GetResult();
+
+      if ((blockParser->IsFinished() ||
+           (node.flags & DocumentNode::UNFINISHED_FLAG) != 0) &&
+          blockResult.GetSize() > 0)
+      {
+        sink.Write(blockResult.GetData(), blockResult.GetSize());
+      }
+    }
+  }
+
+  /**
+   * ParseWithOutline
+   *
+   * Parses the buffer like `Parse`, but every headline gets a unique `id` and
+   * is added to the outline. The slugs depend on all headlines before, so
+   * the document is always parsed in one pass, without the block cache.
+   *
+   * @method
+   * @param {const char*} markdown
+   * @param {size_t} size
+   * @param {OutputSink&} sink
+   * @param {DocumentOutline&} outline
+   * @return {void}
+   */
+  void ParseWithOutline(
+    const char* markdown,
+    size_t size,
+    OutputSink& sink,
+    DocumentOutline& outline
+  ) const
+  {
+    OutlineBuilder builder(outline, sink);
+    Session session(
+      *this, builder, DocumentPlan::Scan(markdown, size), nullptr, &builder
+    );
+    std::string line;
+    const char* current = markdown;
+    const char* end = markdown + size;
+
+    while (current < end)
+    {
+      const char* lineEnd = static_cast<const char*>(
+        std::memchr(current, '\n', static_cast<size_t>(end - current))
+      );
+
+      if (!lineEnd)
+      {
+        lineEnd = end;
+      }
+
+      builder.BeginLine(static_cast<size_t>(current - markdown));
+      line.assign(current, lineEnd);
+      session.AddLine(line);
+      current = lineEnd + 1;
+    }
+
+    session.Finish();
+  }
+
+  /**
+   * CreateSession
+   *
+   * Creates the state for parsing one document line by line. The parser and
+   * the sink have to outlive the session.
+   *
+   * @method
+   * @param {OutputSink&} sink
+   * @return {std::unique_ptr<ParserSession>}
+   */
+  std::unique_ptr<ParserSession> CreateSession(OutputSink& sink) const
+  {
+    return std::unique_ptr<ParserSession>(new Session(*this, sink));
+  }
+
+private:
+  struct BlockParserSet;
+
+  /**
+   * BlockParserPool
+   *
+   * Owns the `BlockParserSet` of every nesting level used while parsing one
+   * document. Levels are created on first use, so a document allocates once
+   * per nesting depth and not once per block.
+   */
+  class BlockParserPool
+  {
+  public:
+    BlockParserPool(
+      const BasicParser& parser,
+      const DocumentPlan& plan,
+      DocumentTreeBuilder* treeBuilder,
+      OutlineBuilder* outlineBuilder
+    )
+      : parser(parser)
+      , plan(plan)
+      , treeBuilder(treeBuilder)
+      , outlineBuilder(outlineBuilder)
+    {}
+
+    // the parsers of every level keep a reference to their pool
+    BlockParserPool(const BlockParserPool&) = delete;
+    BlockParserPool& operator=(const BlockParserPool&) = delete;
+
+    BlockParserSet& GetLevel(size_t depth)
+    {
+      while (this->levels.size() <= depth)
+      {
+        this->levels.emplace_back(
+          new BlockParserSet(this->parser, *this, this->levels.size())
+        );
+      }
+
+      return *this->levels[depth];
+    }
+
+    BlockParser* StartBlock(
+      BlockParser* blockParser, uint32_t blockType, size_t depth
+    )
+    {
+      if (blockParser)
+      {
+        blockParser->Reset();
+
+        if (this->treeBuilder)
+        {
+          this->treeBuilder->OpenBlock(depth, blockType, blockParser);
+        }
+      }
+
+      return blockParser;
+    }
+
+    OutlineBuilder* GetOutlineBuilder() const { return this->outlineBuilder; }
+
+    const DocumentPlan& GetPlan() const { return this->plan; }
+
+  private:
+    const BasicParser& parser;
+    DocumentPlan plan;
+    DocumentTreeBuilder* treeBuilder;
+    OutlineBuilder* outlineBuilder;
+    std::vector<std::unique_ptr<BlockParserSet>> levels;
+  }; // class BlockParserPool
+
+  /**
+   * BlockParserSet
+   *
+   * One in-place instance of every block parser for one nesting level. Only
+   * one block can be open per level at any time, so the instances are reset
+   * and reused for every block instead of being allocated per block.
+   */
+  struct BlockParserSet
+  {
+    BlockParserSet(
+      const BasicParser& parser, BlockParserPool& pool, size_t depth
+    )
+      : checklistParser(
+          [&parser, &pool](std::string& line)
+          { parser.runLineParser(line, pool.GetPlan()); },
+          [&parser, &pool, depth](const std::string& line)
+          { return parser.getChecklistParserForLine(line, pool, depth + 1); }
+        )
+      , codeBlockParser(
+          nullptr,
+          nullptr,
+          parser.features.IsEnabled(maddy::types::CODE_HIGHLIGHT_PARSER) &&
+            (pool.GetPlan().GetPossibleParsers() &
+             maddy::types::CODE_HIGHLIGHT_PARSER) != 0
+        )
+      , headlineParser(
+          [&parser, &pool](std::string& line)
+          { parser.runLineParser(line, pool.GetPlan()); },
+          nullptr,
+          parser.features.IsHeadlineInlineParsingEnabled(),
+          pool.GetOutlineBuilder()
+        )
+      , horizontalLineParser(nullptr, nullptr)
+      , htmlParser(nullptr, nullptr)
+      , latexBlockParser(nullptr, nullptr)
+      , orderedListParser(
+          [&parser, &pool](std::string& line)
+          { parser.runLineParser(line, pool.GetPlan()); },
+          [&parser, &pool, depth](const std::string& line)
+          { return parser.getListParserForLine(line, pool, depth + 1); }
+        )
+      , paragraphParser(
+          [&parser, &pool](std::string& line)
+          { parser.runLineParser(line, pool.GetPlan()); },
+          nullptr,
+          parser.features.IsEnabled(maddy::types::PARAGRAPH_PARSER)
+        )
+      , pipeTableParser(
+          [&parser, &pool](std::string& line)
+          { parser.runLineParser(line, pool.GetPlan()); },
+          nullptr,
+          parser.features.IsEnabled(maddy::types::PARAGRAPH_PARSER)
+        )
+      , quoteParser(
+          [&parser, &pool](std::string& line)
+          { parser.runLineParser(line, pool.GetPlan()); },
+          [&parser, &pool, depth](const std::string& line)
+          { return parser.getBlockParserForLine(line, pool, depth + 1); }
+        )
+      , tableParser(
+          [&parser, &pool](std::string& line)
+          { parser.runLineParser(line, pool.GetPlan()); },
+          nullptr
+        )
+      , unorderedListParser(
+          [&parser, &pool](std::string& line)
+          { parser.runLineParser(line, pool.GetPlan()); },
+          [&parser, &pool, depth](const std::string& line)
+          { return parser.getListParserForLine(line, pool, depth + 1); }
+        )
+    {}
+
+    ChecklistParser checklistParser;
+    CodeBlockParser codeBlockParser;
+    HeadlineParser headlineParser;
+    HorizontalLineParser horizontalLineParser;
+    HtmlParser htmlParser;
+    LatexBlockParser latexBlockParser;
+    OrderedListParser orderedListParser;
+    ParagraphParser paragraphParser;
+    PipeTableParser pipeTableParser;
+    QuoteParser quoteParser;
+    TableParser tableParser;
+    UnorderedListParser unorderedListParser;
+  }; // struct BlockParserSet
+
+  /**
+   * Session
+   *
+   * Feeds the lines of one document to the current block parser and writes
+   * every finished block into the sink.
+   */
+  class Session final : public ParserSession
+  {
+  public:
+    Session(
+      const BasicParser& parser,
+      OutputSink& sink,
+      const DocumentPlan& plan = DocumentPlan(),
+      DocumentTreeBuilder* treeBuilder = nullptr,
+      OutlineBuilder* outlineBuilder = nullptr
+    )
+      : parser(parser)
+      , sink(sink)
+      , pool(parser, plan, treeBuilder, outlineBuilder)
+      , treeBuilder(treeBuilder)
+      , currentBlockParser(nullptr)
+      , budget(parser.limits)
+    {}
+
+    void AddLine(std::string& line) override
+    {
+      if (this->budget.IsExhausted() ||
+          this->parser.limits.IsLineTooLong(line.size()))
+      {
+        this->writeDegradedLine(line);
+        return;
+      }
+
+      if (!this->currentBlockParser)
+      {
+        this->currentBlockParser =
+          this->parser.getBlockParserForLine(line, this->pool, 0);
+      }
+
+      if (this->currentBlockParser)
+      {
+        this->currentBlockParser->AddLine(line);
+
+        if (this->currentBlockParser->IsFinished())
+        {
+          this->writeResult();
+          this->currentBlockParser = nullptr;
+        }
+        else
+        {
+          this->budget.SetPendingOutput(
+            this->currentBlockParser->GetResult().GetSize()
+          );
+        }
+      }
+    }
+
+    // make sure, that all parsers are finished
+    void Finish() override
+    {
+      if (this->currentBlockParser)
+      {
+        std::string emptyLine = "";
+        this->AddLine(emptyLine);
+      }
+
+      this->currentBlockParser = nullptr;
+      this->budget.Reset();
+    }
+
+    bool HasOpenBlock() const override
+    {
+      return this->currentBlockParser != nullptr;
+    }
+
+    /**
+     * AddVerbatimLines
+     *
+     * Lets the open block take the following lines at once, if it only
+     * copies them (see `BlockParser::AddVerbatimLines`). The lines are
+     * passed on in parts of at most `VERBATIM_CHUNK_SIZE` bytes, which are
+     * not larger than the output, which is left in the budget. The budget is
+     * checked after every part.
+     *
+     * @return {const char*} begin of the next line for `AddLine`
+     */
+    const char* AddVerbatimLines(const char* begin, const char* end)
+    {
+      const char* current = begin;
+
+      while (current < end && this->currentBlockParser &&
+             this->currentBlockParser->IsTakingVerbatimLines() &&
+             !this->budget.IsExhausted())
+      {
+        const size_t chunkSize = std::min(
+          static_cast<size_t>(VERBATIM_CHUNK_SIZE),
+          this->budget.GetRemainingOutput()
+        );
+        const char* chunkEnd = end;
+
+        // the part ends behind a complete line, so it has at least one
+        if (static_cast<size_t>(end - current) > chunkSize)
+        {
+          chunkEnd = static_cast<const char*>(std::memchr(
+            current + chunkSize, '\n', static_cast<size_t>(end - current) -
+                                         chunkSize
+          ));
+          chunkEnd = chunkEnd ? chunkEnd + 1 : end;
+        }
+
+        const char* next = this->currentBlockParser->AddVerbatimLines(
+          current, chunkEnd, this->parser.limits.maxLineLength
+        );
+        this->budget.SetPendingOutput(
+          this->currentBlockParser->GetResult().GetSize()
+        );
+
+        // the block stopped in front of a line for `AddLine`
+        if (next != chunkEnd)
+        {
+          return next;
+        }
+
+        current = next;
+      }
+
+      return current;
+    }
+
+    bool IsBudgetExhausted() { return this->budget.IsExhausted(); }
+
+  private:
+    // verbatim lines are passed to the block in parts of at most this size,
+    // so that the budget is checked in between
+    enum : size_t
+    {
+      VERBATIM_CHUNK_SIZE = 64 * 1024
+    };
+
+    const BasicParser& parser;
+    OutputSink& sink;
+    BlockParserPool pool;
+    DocumentTreeBuilder* treeBuilder;
+    BlockParser* currentBlockParser;
+    ParserBudget budget;
+    std::string degradedLine;
+
+    void writeResult()
+    {
+      const OutputBuffer& blockResult = this->currentBlockParser->GetResult();
+
+      if (blockResult.GetSize() > 0)
+      {
+        this->sink.Write(blockResult.GetData(), blockResult.GetSize());
+        this->budget.AddOutput(blockResult.GetSize());
+      }
+
+      this->budget.SetPendingOutput(0);
+    }
+
+    /**
+     * writeDegradedLine
+     *
+     * Writes the line as escaped plain text. A too long line becomes part of
+     * the open block. Once the budget is exhausted, the open block is
+     * written as far as it got. After the time limit all further lines go
+     * straight into the sink, after the output limit they are dropped.
+     */
+    void writeDegradedLine(const std::string& line)
+    {
+      if (this->currentBlockParser && this->budget.IsExhausted())
+      {
+        this->writeResult();
+        this->currentBlockParser = nullptr;
+
+        if (this->treeBuilder)
+        {
+          this->treeBuilder->AbortBlocks();
+        }
+      }
+
+      if (this->budget.IsOutputLimitReached())
+      {
+        return;
+      }
+
+      this->degradedLine.clear();
+      HtmlEscape::Append(this->degradedLine, line.data(), line.size());
+      this->degradedLine += '\n';
+
+      if (this->treeBuilder)
+      {
+        this->treeBuilder->AddTextLine();
+      }
+
+      if (this->currentBlockParser)
+      {
+        this->currentBlockParser->GetResult().Append(this->degradedLine);
+        this->budget.SetPendingOutput(
+          this->currentBlockParser->GetResult().GetSize()
+        );
+        return;
+      }
+
+      this->sink.Write(this->degradedLine.data(), this->degradedLine.size());
+      this->budget.AddOutput(this->degradedLine.size());
+    }
+  }; // class Session
+
+  /**
+   * Chunk
+   *
+   * A part of the document for `ParseParallel` with its own session and
+   * output.
+   */
+  struct Chunk
+  {
+    Chunk(
+      const BasicParser& parser,
+      const DocumentPlan& plan,
+      const char* begin,
+      const char* end
+    )
+      : begin(begin)
+      , end(end)
+      , sink(html)
+      , session(parser, sink, plan)
+    {}
+
+    void WriteTo(OutputSink& output) const
+    {
+      if (!this->html.empty())
+      {
+        output.Write(this->html.data(), this->html.size());
+      }
+    }
+
+    const char* begin;
+    const char* end;
+    std::string html;
+    StringOutputSink sink;
+    Session session;
+    std::exception_ptr error;
+  }; // struct Chunk
+
+  // smaller parts are faster parsed than looked up
+  enum : size_t
+  {
+    MIN_CACHED_SIZE = 32
+  };
+
+  Features features;
+  ParserLimits limits;
+
+  static uint64_t getPartKey(
+    const char* begin,
+    const char* end,
+    const char* documentEnd,
+    uint64_t settingsKey
+  )
+  {
+    // the last part is closed by `Finish`, which can change its HTML
+    if (end == documentEnd)
+    {
+      settingsKey ^= 0x8000000000000000ULL;
+    }
+
+    return ContentHash::Compute(
+      begin, static_cast<size_t>(end - begin), settingsKey
+    );
+  }
+
+  static void writeHtml(OutputSink& sink, std::string& html)
+  {
+    if (!html.empty())
+    {
+      sink.Write(html.data(), html.size());
+      html.clear();
+    }
+  }
+
+  static void addLines(Session& session, const char* begin, const char* end)
+  {
+    std::string line;
+    const char* current = begin;
+
+    while (current < end)
+    {
+      const char* lineEnd = static_cast<const char*>(
+        std::memchr(current, '\n', static_cast<size_t>(end - current))
+      );
+
+      if (!lineEnd)
+      {
+        lineEnd = end;
+      }
+
+      line.assign(current, lineEnd);
+      session.AddLine(line);
+      current = lineEnd + 1;
+
+      if (current < end)
+      {
+        current = session.AddVerbatimLines(current, end);
+      }
+    }
+  }
+
+  static bool startsWith(const char* begin, const char* end, const char* text)
+  {
+    const size_t length = std::strlen(text);
+
+    return static_cast<size_t>(end - begin) >= length &&
+           std::memcmp(begin, text, length) == 0;
+  }
+
+  static bool endsWith(const char* begin, const char* end, const char* text)
+  {
+    const size_t length = std::strlen(text);
+
+    return static_cast<size_t>(end - begin) >= length &&
+           std::memcmp(end - length, text, length) == 0;
+  }
+
+  /**
+   * findSplitPoints
+   *
+   * Returns the chunk boundaries for `ParseParallel`, including the begin
+   * and the end of the document. A chunk ends behind a blank line, which is
+   * not inside a code, LaTeX or HTML block. Such a blank line closes every
+   * other block.
+   */
+  static std::vector<const char*> findSplitPoints(
+    const char* markdown, size_t size, size_t chunkSize
+  )
+  {
+    std::vector<const char*> splitPoints(1, markdown);
+    const char* end = markdown + size;
+    const char* current = markdown;
+    bool isInCodeBlock = false;
+    bool isInLatexBlock = false;
+    bool isInHtmlBlock = false;
+    bool isGreaterThanFound = false;
+
+    while (current < end)
+    {
+      const char* lineEnd = static_cast<const char*>(
+        std::memchr(current, '\n', static_cast<size_t>(end - current))
+      );
+
+      if (!lineEnd)
+      {
+        break;
+      }
+
+      const char* next = lineEnd + 1;
+
+      if (current == lineEnd)
+      {
+        if (isInHtmlBlock && isGreaterThanFound)
+        {
+          isInHtmlBlock = false;
+        }
+        else if (!isInCodeBlock && !isInLatexBlock && !isInHtmlBlock &&
+                 static_cast<size_t>(next - splitPoints.back()) >= chunkSize)
+        {
+          splitPoints.push_back(next);
+        }
+
+        current = next;
+        continue;
+      }
+
+      if (!isInCodeBlock && !isInLatexBlock && *current == '<')
+      {
+        isInHtmlBlock = true;
+      }
+
+      isGreaterThanFound = lineEnd[-1] == '>';
+
+      // fences can also be inside of quotes
+      const char* content = current;
+
+      while (content < lineEnd && (*content == '>' || *content == ' '))
+      {
+        ++content;
+      }
+
+      if (isInLatexBlock)
+      {
+        isInLatexBlock = !endsWith(content, lineEnd, "$$");
+      }
+      else if (startsWith(content, lineEnd, "```"))
+      {
+        isInCodeBlock = !isInCodeBlock;
+      }
+      else if (!isInCodeBlock && startsWith(content, lineEnd, "$$"))
+      {
+        isInLatexBlock = !endsWith(content, lineEnd, "$$");
+      }
+
+      current = next;
+    }
+
+    if (splitPoints.back() != end)
+    {
+      splitPoints.push_back(end);
+    }
+
+    return splitPoints;
+  }
+
+  // block parser have to run before
+  void runLineParser(std::string& line, const DocumentPlan& plan) const
+  {
+    if (plan.HasInlineMarkup())
+    {
+      InlineParser::Parse(
+        line,
+        PlannedParserFeatures<Features>(
+          this->features, plan.GetPossibleParsers()
+        )
+      );
+    }
+  }
+
+  bool isCandidate(uint32_t candidates, uint32_t parserType) const
+  {
+    return (candidates & parserType) != 0 &&
+           this->features.IsEnabled(parserType);
+  }
+
+  BlockParser* getBlockParserForLine(
+    const std::string& line, BlockParserPool& pool, size_t depth
+  ) const
+  {
+    if (this->limits.IsNestingTooDeep(depth))
+    {
+      return nullptr;
+    }
+
+    BlockParserSet& level = pool.GetLevel(depth);
+    BlockParser* parser = nullptr;
+    uint32_t blockType = 0;
+    const uint32_t candidates = BlockClassifier::GetCandidates(line) &
+                                pool.GetPlan().GetPossibleParsers();
+
+    if (this->isCandidate(candidates, maddy::types::CODE_BLOCK_PARSER) &&
+        maddy::CodeBlockParser::IsStartingLine(line))
+    {
+      parser = &level.codeBlockParser;
+      blockType = maddy::types::CODE_BLOCK_PARSER;
+    }
+    else if (this->isCandidate(candidates, maddy::types::LATEX_BLOCK_PARSER) &&
+             maddy::LatexBlockParser::IsStartingLine(line))
+    {
+      parser = &level.latexBlockParser;
+      blockType = maddy::types::LATEX_BLOCK_PARSER;
+    }
+    else if (this->isCandidate(candidates, maddy::types::HEADLINE_PARSER) &&
+             maddy::HeadlineParser::IsStartingLine(line))
+    {
+      parser = &level.headlineParser;
+      blockType = maddy::types::HEADLINE_PARSER;
+    }
+    else if (this->isCandidate(
+               candidates, maddy::types::HORIZONTAL_LINE_PARSER
+             ) &&
+             maddy::HorizontalLineParser::IsStartingLine(line))
+    {
+      parser = &level.horizontalLineParser;
+      blockType = maddy::types::HORIZONTAL_LINE_PARSER;
+    }
+    else if (this->isCandidate(candidates, maddy::types::QUOTE_PARSER) &&
+             maddy::QuoteParser::IsStartingLine(line))
+    {
+      parser = &level.quoteParser;
+      blockType = maddy::types::QUOTE_PARSER;
+    }
+    else if (this->isCandidate(candidates, maddy::types::TABLE_PARSER) &&
+             maddy::TableParser::IsStartingLine(line))
+    {
+      parser = &level.tableParser;
+      blockType = maddy::types::TABLE_PARSER;
+    }
+    else if (this->isCandidate(candidates, maddy::types::PIPE_TABLE_PARSER) &&
+             maddy::PipeTableParser::IsStartingLine(line))
+    {
+      parser = &level.pipeTableParser;
+      blockType = maddy::types::PIPE_TABLE_PARSER;
+    }
+    else if (this->isCandidate(candidates, maddy::types::CHECKLIST_PARSER) &&
+             maddy::ChecklistParser::IsStartingLine(line))
+    {
+      parser = &level.checklistParser;
+      blockType = maddy::types::CHECKLIST_PARSER;
+    }
+    else if (this->isCandidate(candidates, maddy::types::ORDERED_LIST_PARSER) &&
+             maddy::OrderedListParser::IsStartingLine(line))
+    {
+      parser = &level.orderedListParser;
+      blockType = maddy::types::ORDERED_LIST_PARSER;
+    }
+    else if (this->isCandidate(
+               candidates, maddy::types::UNORDERED_LIST_PARSER
+             ) &&
+             maddy::UnorderedListParser::IsStartingLine(line))
+    {
+      parser = &level.unorderedListParser;
+      blockType = maddy::types::UNORDERED_LIST_PARSER;
+    }
+    else if (this->isCandidate(candidates, maddy::types::HTML_PARSER) &&
+             maddy::HtmlParser::IsStartingLine(line))
+    {
+      parser = &level.htmlParser;
+      blockType = maddy::types::HTML_PARSER;
+    }
+    else if (maddy::ParagraphParser::IsStartingLine(line))
+    {
+      parser = &level.paragraphParser;
+      blockType = maddy::types::PARAGRAPH_PARSER;
+    }
+
+    return pool.StartBlock(parser, blockType, depth);
+  }
+
+  static void appendTextLine(
+    std::string& text, const char* markdown, const DocumentNode& node
+  )
+  {
+    HtmlEscape::Append(text, markdown + node.sourceOffset, node.sourceSize);
+    text += '\n';
+  }
+
+  /**
+   * renderBlock
+   *
+   * Gives the lines of a top-level node of `RenderTree` to its block parser.
+   * The text nodes of the block are appended as escaped plain text instead.
+   */
+  void renderBlock(
+    BlockParser& blockParser,
+    const char* markdown,
+    const std::vector<DocumentNode>& nodes,
+    const DocumentNode& node
+  ) const
+  {
+    uint32_t textNode = node.firstChild;
+    std::string line;
+    const char* current = markdown + node.sourceOffset;
+    const char* end = current + node.sourceSize;
+
+    // the last line of the node ends at `end`, it can be empty
+    while (current <= end)
+    {
+      while (textNode != DocumentTree::NO_NODE &&
+             (nodes[textNode].kind != DocumentNode::TEXT_NODE ||
+              markdown + nodes[textNode].sourceOffset < current))
+      {
+        textNode = nodes[textNode].nextSibling;
+      }
+
+      const char* lineEnd = static_cast<const char*>(
+        std::memchr(current, '\n', static_cast<size_t>(end - current))
+      );
+
+      if (!lineEnd)
+      {
+        lineEnd = end;
+      }
+
+      if (textNode != DocumentTree::NO_NODE &&
+          markdown + nodes[textNode].sourceOffset == current)
+      {
+        line.clear();
+        appendTextLine(line, markdown, nodes[textNode]);
+        blockParser.GetResult().Append(line);
+      }
+      else
+      {
+        line.assign(current, lineEnd);
+        blockParser.AddLine(line);
+      }
+
+      current = lineEnd + 1;
+
+      if (current < end && blockParser.IsTakingVerbatimLines())
+      {
+        current = blockParser.AddVerbatimLines(
+          current, end, this->limits.maxLineLength
+        );
+      }
+    }
+
+    // the block was still open at the end of the document, see `Finish`
+    if (!blockParser.IsFinished() &&
+        (node.flags & DocumentNode::UNFINISHED_FLAG) == 0)
+    {
+      line.clear();
+      blockParser.AddLine(line);
+    }
+  }
+
+  static BlockParser* getBlockParserOfType(
+    uint32_t blockType, BlockParserSet& level
+  )
+  {
+    switch (blockType)
+    {
+      case maddy::types::CHECKLIST_PARSER:
+        return &level.checklistParser;
+      case maddy::types::CODE_BLOCK_PARSER:
+        return &level.codeBlockParser;
+      case maddy::types::HEADLINE_PARSER:
+        return &level.headlineParser;
+      case maddy::types::HORIZONTAL_LINE_PARSER:
+        return &level.horizontalLineParser;
+      case maddy::types::HTML_PARSER:
+        return &level.htmlParser;
+      case maddy::types::LATEX_BLOCK_PARSER:
+        return &level.latexBlockParser;
+      case maddy::types::ORDERED_LIST_PARSER:
+        return &level.orderedListParser;
+      case maddy::types::PARAGRAPH_PARSER:
+        return &level.paragraphParser;
+      case maddy::types::PIPE_TABLE_PARSER:
+        return &level.pipeTableParser;
+      case maddy::types::QUOTE_PARSER:
+        return &level.quoteParser;
+      case maddy::types::TABLE_PARSER:
+        return &level.tableParser;
+      case maddy::types::UNORDERED_LIST_PARSER:
+        return &level.unorderedListParser;
+      default:
+        return nullptr;
+    }
+  }
+
+  BlockParser* getChecklistParserForLine(
+    const std::string& line, BlockParserPool& pool, size_t depth
+  ) const
+  {
+    if (this->limits.IsNestingTooDeep(depth))
+    {
+      return nullptr;
+    }
+
+    BlockParser* parser = nullptr;
+    uint32_t blockType = 0;
+
+    const uint32_t candidates = BlockClassifier::GetCandidates(line) &
+                                pool.GetPlan().GetPossibleParsers();
+
+    if (this->isCandidate(candidates, maddy::types::CHECKLIST_PARSER) &&
+        maddy::ChecklistParser::IsStartingLine(line))
+    {
+      parser = &pool.GetLevel(depth).checklistParser;
+      blockType = maddy::types::CHECKLIST_PARSER;
+    }
+
+    return pool.StartBlock(parser, blockType, depth);
+  }
+
+  BlockParser* getListParserForLine(
+    const std::string& line, BlockParserPool& pool, size_t depth
+  ) const
+  {
+    if (this->limits.IsNestingTooDeep(depth))
+    {
+      return nullptr;
+    }
+
+    BlockParser* parser = nullptr;
+    uint32_t blockType = 0;
+    const uint32_t candidates = BlockClassifier::GetCandidates(line) &
+                                pool.GetPlan().GetPossibleParsers();
+
+    if (this->isCandidate(candidates, maddy::types::ORDERED_LIST_PARSER) &&
+        maddy::OrderedListParser::IsStartingLine(line))
+    {
+      parser = &pool.GetLevel(depth).orderedListParser;
+      blockType = maddy::types::ORDERED_LIST_PARSER;
+    }
+    else if (this->isCandidate(
+               candidates, maddy::types::UNORDERED_LIST_PARSER
+             ) &&
+             maddy::UnorderedListParser::IsStartingLine(line))
+    {
+      parser = &pool.GetLevel(depth).unorderedListParser;
+      blockType = maddy::types::UNORDERED_LIST_PARSER;
+    }
+
+    return pool.StartBlock(parser, blockType, depth);
+  }
+}; // class BasicParser
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
@@ -0,0 +1,217 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * BlockCache
+ *
+ * Memo cache for the HTML of blocks, which is shared by all parsers with the
+ * cache in their `ParserConfig`. The key is a `ContentHash` of the block
+ * source and the parser settings, so one cache can be used by parsers with
+ * different configs.
+ *
+ * The cache holds at most `maxBytes` (roughly, the HTML plus a fixed
+ * overhead per entry). If it is full, the least recently used blocks are
+ * dropped. All methods are thread-safe.
+ *
+ * ```
+ * std::shared_ptr<maddy::ParserConfig> config =
+ *   std::make_shared<maddy::ParserConfig>();
+ * config->blockCache = std::make_shared<maddy::BlockCache>(64 * 1024 * 1024);
+ * ```
+ *
+ * @class
+ */
+class BlockCache
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   * @param {size_t} maxBytes
+   */
+  explicit BlockCache(size_t maxBytes = 32 * 1024 * 1024)
+    : maxBytes(maxBytes)
+    , usedBytes(0)
+    , hitCount(0)
+    , missCount(0)
+  {}
+
+  /**
+   * Find
+   *
+   * @method
+   * @param {uint64_t} key
+   * @param {size_t} sourceSize
+   * @param {std::string&} html is replaced on a hit
+   * @return {bool} if the block was found
+   */
+  bool Find(uint64_t key, size_t sourceSize, std::string& html)
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->index.find(key);
+
+    if (it == this->index.end() || it->second->sourceSize != sourceSize)
+    {
+      ++this->missCount;
+      return false;
+    }
+
+    // most recently used to the front
+    this->entries.splice(this->entries.begin(), this->entries, it->second);
+    html = it->second->html;
+    ++this->hitCount;
+
+    return true;
+  }
+
+  /**
+   * Insert
+   *
+   * Blocks, which are larger than the whole cache, are not stored.
+   *
+   * @method
+   * @param {uint64_t} key
+   * @param {size_t} sourceSize
+   * @param {const std::string&} html
+   * @return {void}
+   */
+  void Insert(uint64_t key, size_t sourceSize, const std::string& html)
+  {
+    const size_t entryBytes = getEntryBytes(html);
+
+    if (entryBytes > this->maxBytes)
+    {
+      return;
+    }
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    if (this->index.find(key) != this->index.end())
+    {
+      return;
+    }
+
+    while (this->usedBytes + entryBytes > this->maxBytes)
+    {
+      const Entry& last = this->entries.back();
+      this->usedBytes -= getEntryBytes(last.html);
+      this->index.erase(last.key);
+      this->entries.pop_back();
+    }
+
+    Entry entry = {key, sourceSize, html};
+    this->entries.push_front(entry);
+    this->index[key] = this->entries.begin();
+    this->usedBytes += entryBytes;
+  }
+
+  /**
+   * Clear
+   *
+   * Removes all blocks and resets the counters.
+   *
+   * @method
+   * @return {void}
+   */
+  void Clear()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->entries.clear();
+    this->index.clear();
+    this->usedBytes = 0;
+    this->hitCount = 0;
+    this->missCount = 0;
+  }
+
+  /**
+   * GetHitCount
+   *
+   * @method
+   * @return {size_t}
+   */
+  size_t GetHitCount() const
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->hitCount;
+  }
+
+  /**
+   * GetMissCount
+   *
+   * @method
+   * @return {size_t}
+   */
+  size_t GetMissCount() const
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->missCount;
+  }
+
+  /**
+   * GetEntryCount
+   *
+   * @method
+   * @return {size_t}
+   */
+  size_t GetEntryCount() const
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->index.size();
+  }
+
+  /**
+   * GetUsedBytes
+   *
+   * @method
+   * @return {size_t}
+   */
+  size_t GetUsedBytes() const
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->usedBytes;
+  }
+
+private:
+  struct Entry
+  {
+    uint64_t key;
+    size_t sourceSize;
+    std::string html;
+  };
+
+  mutable std::mutex mutex;
+  std::list<Entry> entries;
+  std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+  size_t maxBytes;
+  size_t usedBytes;
+  size_t hitCount;
+  size_t missCount;
+
+  static size_t getEntryBytes(const std::string& html)
+  {
+    // list node, map node and bucket
+    return html.size() + sizeof(Entry) + 64;
+  }
+}; // class BlockCache
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
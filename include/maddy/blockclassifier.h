@@ -0,0 +1,85 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <string>
+
+#include "maddy/parserconfig.h"
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * BlockClassifier
+ *
+ * Every block parser can only start at a line with one of a few first bytes,
+ * e.g. a headline only at `#` and a quote only at `>`. A table of all 256
+ * byte values maps the first byte of a line to the block parsers, whose
+ * `IsStartingLine` can match at all. Most lines of a document start with a
+ * letter and get no candidates, so they are known to be paragraph lines
+ * without running any matcher.
+ *
+ * @class
+ */
+class BlockClassifier
+{
+public:
+  /**
+   * GetCandidates
+   *
+   * @method
+   * @param {const std::string&} line
+   * @return {uint32_t} the `maddy::types` of the possible block parsers
+   */
+  static uint32_t GetCandidates(const std::string& line)
+  {
+    if (line.empty())
+    {
+      return 0;
+    }
+
+    return getTable()[static_cast<unsigned char>(line[0])];
+  }
+
+private:
+  struct Table
+  {
+    uint32_t candidates[256];
+
+    Table()
+      : candidates()
+    {
+      this->candidates['`'] = maddy::types::CODE_BLOCK_PARSER;
+      this->candidates['$'] = maddy::types::LATEX_BLOCK_PARSER;
+      this->candidates['#'] = maddy::types::HEADLINE_PARSER;
+      this->candidates['-'] = maddy::types::HORIZONTAL_LINE_PARSER |
+                              maddy::types::CHECKLIST_PARSER |
+                              maddy::types::UNORDERED_LIST_PARSER;
+      this->candidates['>'] = maddy::types::QUOTE_PARSER;
+      this->candidates['|'] =
+        maddy::types::TABLE_PARSER | maddy::types::PIPE_TABLE_PARSER;
+      this->candidates['1'] = maddy::types::ORDERED_LIST_PARSER;
+      this->candidates['*'] = maddy::types::UNORDERED_LIST_PARSER;
+      this->candidates['+'] = maddy::types::UNORDERED_LIST_PARSER;
+      this->candidates['<'] = maddy::types::HTML_PARSER;
+    }
+  };
+
+  static const uint32_t* getTable()
+  {
+    static const Table table;
+    return table.candidates;
+  }
+}; // class BlockClassifier
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
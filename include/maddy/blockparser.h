@@ -6,19 +6,25 @@
 
 // -----------------------------------------------------------------------------
 
+#include <cstddef>
+#include <cstring>
 #include <functional>
-#include <sstream>
 #include <string>
 // windows compatibility includes
 #include <algorithm>
 #include <cctype>
 
+#include "maddy/bytescanner.h"
+#include "maddy/outputbuffer.h"
+
 // -----------------------------------------------------------------------------
 
 namespace maddy {
 
 // -----------------------------------------------------------------------------
 
+class ContainerParser;
+
 /**
  * BlockParser
  *
@@ -26,6 +32,10 @@ namespace maddy {
  * implemented:
  * `static bool IsStartingLine(const std::string& line)`
  *
+ * Child parsers append to the `result` of their parent (see `OutputBuffer`),
+ * so only the parser of a top-level block has the whole HTML of the block in
+ * its result.
+ *
  * @class
  */
 class BlockParser
@@ -36,16 +46,16 @@ public:
    *
    * @method
    * @param {std::function<void(std::string&)>} parseLineCallback
-   * @param {std::function<std::shared_ptr<BlockParser>(const std::string&
-   * line)>} getBlockParserForLineCallback
+   * @param {std::function<BlockParser*(const std::string& line)>}
+   * getBlockParserForLineCallback
    */
   BlockParser(
     std::function<void(std::string&)> parseLineCallback,
-    std::function<std::shared_ptr<BlockParser>(const std::string& line)>
+    std::function<BlockParser*(const std::string& line)>
       getBlockParserForLineCallback
   )
-    : result("", std::ios_base::ate | std::ios_base::in | std::ios_base::out)
-    , childParser(nullptr)
+    : childParser(nullptr)
+    , childResultBegin(0)
     , parseLineCallback(parseLineCallback)
     , getBlockParserForLineCallback(getBlockParserForLineCallback)
   {}
@@ -79,12 +89,7 @@ public:
     {
       this->childParser->AddLine(line);
 
-      if (this->childParser->IsFinished())
-      {
-        this->result << this->childParser->GetResult().str();
-        this->childParser = nullptr;
-      }
-
+      this->finishChildLine();
       return;
     }
 
@@ -96,6 +101,41 @@ public:
     this->result << line;
   }
 
+  /**
+   * IsTakingVerbatimLines
+   *
+   * If the block copies its next lines (e.g. the body of a code block), so
+   * that `AddVerbatimLines` can take them.
+   *
+   * @method
+   * @return {bool}
+   */
+  virtual bool IsTakingVerbatimLines() const { return false; }
+
+  /**
+   * AddVerbatimLines
+   *
+   * Fast path for the body of blocks, which copy their lines: takes the
+   * complete lines from `begin` on with the same result as passing each one
+   * to `AddLine`, but without materializing them. It stops in front of the
+   * first line, which could finish the block, does not end with `\n` or is
+   * longer than `maxLineLength`, those lines go through `AddLine`.
+   *
+   * Only used for top-level blocks, which own their result.
+   *
+   * @method
+   * @param {const char*} begin
+   * @param {const char*} end
+   * @param {size_t} maxLineLength 0 for no limit
+   * @return {const char*} begin of the first line, which was not taken
+   */
+  virtual const char* AddVerbatimLines(
+    const char* begin, const char* /* end */, size_t /* maxLineLength */
+  )
+  {
+    return begin;
+  }
+
   /**
    * IsFinished
    *
@@ -112,9 +152,9 @@ public:
    * Get the parsed HTML output.
    *
    * @method
-   * @return {std::stringstream}
+   * @return {OutputBuffer&}
    */
-  std::stringstream& GetResult() { return this->result; }
+  OutputBuffer& GetResult() { return this->result; }
 
   /**
    * Clear
@@ -126,16 +166,45 @@ public:
    * @method
    * @return {void}
    */
-  void Clear() { this->result.str(""); }
+  void Clear() { this->result.Clear(); }
+
+  /**
+   * Reset
+   *
+   * Puts the parser back into its initial state, so that the same object can
+   * be used for the next block. Child parsers are not owned by the parser,
+   * they are handed out (and reused) by the `getBlockParserForLineCallback`.
+   *
+   * @method
+   * @return {void}
+   */
+  virtual void Reset()
+  {
+    this->Clear();
+    this->childParser = nullptr;
+  }
 
 protected:
-  std::stringstream result;
-  std::shared_ptr<BlockParser> childParser;
+  // the top-level `ContainerParser` walks all nested levels
+  friend class ContainerParser;
+
+  OutputBuffer result;
+  BlockParser* childParser;
+  // size of the result, when the child parser was started
+  size_t childResultBegin;
 
   virtual bool isInlineBlockAllowed() const = 0;
   virtual bool isLineParserAllowed() const = 0;
   virtual void parseBlock(std::string& line) = 0;
 
+  /**
+   * asContainer
+   *
+   * @method
+   * @return {ContainerParser*} nullptr, if the block contains no other blocks
+   */
+  virtual ContainerParser* asContainer() { return nullptr; }
+
   void parseLine(std::string& line)
   {
     if (parseLineCallback)
@@ -144,46 +213,141 @@ protected:
     }
   }
 
+  /**
+   * hasNoLineBreakFrom
+   *
+   * Hand-written equivalent of a trailing `.*` in `std::regex_match`: `.`
+   * matches everything except `\r` and `\n`.
+   *
+   * @method
+   * @param {const std::string&} line
+   * @param {size_t} pos
+   * @return {bool}
+   */
+  static bool hasNoLineBreakFrom(const std::string& line, size_t pos)
+  {
+    static const ByteScanner lineBreakScanner("\r\n");
+
+    return pos <= line.size() &&
+           lineBreakScanner.Find(line, pos) == std::string::npos;
+  }
+
+  /**
+   * erasePrefix
+   *
+   * Hand-written equivalent of `std::regex_replace` with a `^`-anchored
+   * literal, which is linear and uses no recursion on long lines.
+   *
+   * @method
+   * @param {std::string&} line
+   * @param {const char*} prefix
+   * @return {bool} if the line started with the prefix
+   */
+  static bool erasePrefix(std::string& line, const char* prefix)
+  {
+    const size_t length = std::char_traits<char>::length(prefix);
+
+    if (line.compare(0, length, prefix) != 0)
+    {
+      return false;
+    }
+
+    line.erase(0, length);
+    return true;
+  }
+
+  /**
+   * findVerbatimLineEnd
+   *
+   * @method
+   * @param {const char*} begin of the line
+   * @param {const char*} end of the buffer
+   * @param {size_t} maxLineLength 0 for no limit
+   * @return {const char*} the `\n` of the line, nullptr if the line does not
+   * end before `end` or is too long for `AddVerbatimLines`
+   */
+  static const char* findVerbatimLineEnd(
+    const char* begin, const char* end, size_t maxLineLength
+  )
+  {
+    const char* lineEnd = static_cast<const char*>(
+      std::memchr(begin, '\n', static_cast<size_t>(end - begin))
+    );
+
+    if (lineEnd && maxLineLength != 0 &&
+        static_cast<size_t>(lineEnd - begin) > maxLineLength)
+    {
+      return nullptr;
+    }
+
+    return lineEnd;
+  }
+
+  /**
+   * getIndentationWidth
+   *
+   * Counts the whitespace at the start of the line, the rest of the line is
+   * not read.
+   *
+   * @method
+   * @param {const std::string&} line
+   * @return {uint32_t}
+   */
   uint32_t getIndentationWidth(const std::string& line) const
   {
-    bool hasMetNonSpace = false;
-
-    uint32_t indentation = static_cast<uint32_t>(std::count_if(
-      line.begin(),
-      line.end(),
-      [&hasMetNonSpace](unsigned char c)
-      {
-        if (hasMetNonSpace)
-        {
-          return false;
-        }
-
-        if (std::isspace(c))
-        {
-          return true;
-        }
-
-        hasMetNonSpace = true;
-        return false;
-      }
-    ));
+    uint32_t indentation = 0;
+
+    while (indentation < line.size() &&
+           std::isspace(static_cast<unsigned char>(line[indentation])))
+    {
+      ++indentation;
+    }
 
     return indentation;
   }
 
-  std::shared_ptr<BlockParser> getBlockParserForLine(const std::string& line)
+  BlockParser* getBlockParserForLine(const std::string& line)
   {
-    if (getBlockParserForLineCallback)
+    if (!getBlockParserForLineCallback)
+    {
+      return nullptr;
+    }
+
+    BlockParser* parser = getBlockParserForLineCallback(line);
+
+    if (parser)
     {
-      return getBlockParserForLineCallback(line);
+      parser->result.ShareWith(this->result);
+      this->childResultBegin = this->result.GetSize();
     }
 
-    return nullptr;
+    return parser;
+  }
+
+  /**
+   * finishChildLine
+   *
+   * Called after the child parser got a line. The HTML of a child is only
+   * part of the result, if the child is finished before its parent.
+   *
+   * @method
+   * @return {void}
+   */
+  void finishChildLine()
+  {
+    if (this->childParser->IsFinished())
+    {
+      this->childParser = nullptr;
+    }
+    else if (this->IsFinished())
+    {
+      this->result.Truncate(this->childResultBegin);
+    }
   }
 
 private:
   std::function<void(std::string&)> parseLineCallback;
-  std::function<std::shared_ptr<BlockParser>(const std::string& line)>
+  std::function<BlockParser*(const std::string& line)>
     getBlockParserForLineCallback;
 }; // class BlockParser
 
@@ -6,9 +6,9 @@
 
 // -----------------------------------------------------------------------------
 
-#include <regex>
 #include <string>
 
+#include "maddy/inlineparser.h"
 #include "maddy/lineparser.h"
 
 // -----------------------------------------------------------------------------
@@ -38,10 +38,7 @@ public:
    */
   void Parse(std::string& line) override
   {
-    static std::regex re(R"((\r\n|\r))");
-    static std::string replacement = "<br>";
-
-    line = std::regex_replace(line, re, replacement);
+    InlineParser::ParseBreakLines(line);
   }
 }; // class BreakLineParser
 
@@ -0,0 +1,307 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <cstddef>
+#include <string>
+
+#include "maddy/simd.h"
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * ByteScanner
+ *
+ * Finds the bytes out of a small set (up to 16 bytes), e.g. the bytes which
+ * can start inline markup. The text is compared 32 (AVX2) or 16 (SSE2) bytes
+ * at a time, the rest and builds without SIMD use a lookup table.
+ *
+ * ```
+ * static const maddy::ByteScanner scanner("*_`");
+ * const char* markup = scanner.Find(line.data(), line.data() + line.size());
+ * ```
+ *
+ * @class
+ */
+class ByteScanner
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   * @param {const char*} bytes zero-terminated, at most 16 bytes are used
+   */
+  explicit ByteScanner(const char* bytes)
+    : table()
+    , bytes()
+    , count(0)
+  {
+    for (; *bytes != '\0' && this->count < MAX_BYTES; ++bytes)
+    {
+      this->bytes[this->count++] = *bytes;
+      this->table[static_cast<unsigned char>(*bytes)] =
+        static_cast<uint8_t>(this->count);
+    }
+  }
+
+  /**
+   * Contains
+   *
+   * @method
+   * @param {char} c
+   * @return {bool}
+   */
+  bool Contains(char c) const
+  {
+    return this->table[static_cast<unsigned char>(c)] != 0;
+  }
+
+  /**
+   * Find
+   *
+   * @method
+   * @param {const char*} begin
+   * @param {const char*} end
+   * @return {const char*} the first byte of the set or `end`
+   */
+  const char* Find(const char* begin, const char* end) const
+  {
+#if defined(MADDY_SIMD_AVX2)
+    begin = this->findAvx2(begin, end);
+#elif defined(MADDY_SIMD_SSE2)
+    begin = this->findSse2(begin, end);
+#endif
+
+    while (begin < end && !this->Contains(*begin))
+    {
+      ++begin;
+    }
+
+    return begin;
+  }
+
+  /**
+   * Find
+   *
+   * @method
+   * @param {const std::string&} text
+   * @param {size_t} pos
+   * @return {size_t} the position of the first byte of the set from `pos` on
+   * or `std::string::npos`
+   */
+  size_t Find(const std::string& text, size_t pos = 0) const
+  {
+    if (pos >= text.size())
+    {
+      return std::string::npos;
+    }
+
+    const char* end = text.data() + text.size();
+    const char* found = this->Find(text.data() + pos, end);
+
+    return found == end ? std::string::npos
+                        : static_cast<size_t>(found - text.data());
+  }
+
+  /**
+   * Collect
+   *
+   * Scans the whole text without stopping at the bytes of the set.
+   *
+   * @method
+   * @param {const char*} begin
+   * @param {const char*} end
+   * @return {uint32_t} bit `i` is set, if the `i`th byte of the set occurs
+   */
+  uint32_t Collect(const char* begin, const char* end) const
+  {
+    uint32_t found = 0;
+
+#if defined(MADDY_SIMD_AVX2)
+    begin = this->collectAvx2(begin, end, found);
+#elif defined(MADDY_SIMD_SSE2)
+    begin = this->collectSse2(begin, end, found);
+#endif
+
+    for (; begin < end; ++begin)
+    {
+      const uint8_t index = this->table[static_cast<unsigned char>(*begin)];
+
+      if (index != 0)
+      {
+        found |= 1u << (index - 1);
+      }
+    }
+
+    return found;
+  }
+
+private:
+  enum : size_t
+  {
+    MAX_BYTES = 16
+  };
+
+  // index in `bytes` + 1, 0 for bytes outside of the set
+  uint8_t table[256];
+  char bytes[MAX_BYTES];
+  size_t count;
+
+#if defined(MADDY_SIMD_AVX2)
+  // returns the first byte of the set or the begin of the unscanned tail
+  const char* findAvx2(const char* begin, const char* end) const
+  {
+    __m256i sets[MAX_BYTES];
+
+    for (size_t i = 0; i < this->count; ++i)
+    {
+      sets[i] = _mm256_set1_epi8(this->bytes[i]);
+    }
+
+    while (end - begin >= 32)
+    {
+      const __m256i chunk =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+      __m256i hits = _mm256_setzero_si256();
+
+      for (size_t i = 0; i < this->count; ++i)
+      {
+        hits = _mm256_or_si256(hits, _mm256_cmpeq_epi8(chunk, sets[i]));
+      }
+
+      const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits));
+
+      if (mask != 0)
+      {
+        return begin + simd::CountTrailingZeros(mask);
+      }
+
+      begin += 32;
+    }
+
+    return begin;
+  }
+
+  // returns the begin of the unscanned tail
+  const char* collectAvx2(
+    const char* begin, const char* end, uint32_t& found
+  ) const
+  {
+    __m256i sets[MAX_BYTES];
+    __m256i hits[MAX_BYTES];
+
+    for (size_t i = 0; i < this->count; ++i)
+    {
+      sets[i] = _mm256_set1_epi8(this->bytes[i]);
+      hits[i] = _mm256_setzero_si256();
+    }
+
+    for (; end - begin >= 32; begin += 32)
+    {
+      const __m256i chunk =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+
+      for (size_t i = 0; i < this->count; ++i)
+      {
+        hits[i] = _mm256_or_si256(hits[i], _mm256_cmpeq_epi8(chunk, sets[i]));
+      }
+    }
+
+    for (size_t i = 0; i < this->count; ++i)
+    {
+      if (_mm256_movemask_epi8(hits[i]) != 0)
+      {
+        found |= 1u << i;
+      }
+    }
+
+    return begin;
+  }
+#endif
+
+#if defined(MADDY_SIMD_SSE2) && !defined(MADDY_SIMD_AVX2)
+  // returns the first byte of the set or the begin of the unscanned tail
+  const char* findSse2(const char* begin, const char* end) const
+  {
+    __m128i sets[MAX_BYTES];
+
+    for (size_t i = 0; i < this->count; ++i)
+    {
+      sets[i] = _mm_set1_epi8(this->bytes[i]);
+    }
+
+    while (end - begin >= 16)
+    {
+      const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+      __m128i hits = _mm_setzero_si128();
+
+      for (size_t i = 0; i < this->count; ++i)
+      {
+        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(chunk, sets[i]));
+      }
+
+      const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(hits));
+
+      if (mask != 0)
+      {
+        return begin + simd::CountTrailingZeros(mask);
+      }
+
+      begin += 16;
+    }
+
+    return begin;
+  }
+
+  // returns the begin of the unscanned tail
+  const char* collectSse2(
+    const char* begin, const char* end, uint32_t& found
+  ) const
+  {
+    __m128i sets[MAX_BYTES];
+    __m128i hits[MAX_BYTES];
+
+    for (size_t i = 0; i < this->count; ++i)
+    {
+      sets[i] = _mm_set1_epi8(this->bytes[i]);
+      hits[i] = _mm_setzero_si128();
+    }
+
+    for (; end - begin >= 16; begin += 16)
+    {
+      const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+
+      for (size_t i = 0; i < this->count; ++i)
+      {
+        hits[i] = _mm_or_si128(hits[i], _mm_cmpeq_epi8(chunk, sets[i]));
+      }
+    }
+
+    for (size_t i = 0; i < this->count; ++i)
+    {
+      if (_mm_movemask_epi8(hits[i]) != 0)
+      {
+        found |= 1u << i;
+      }
+    }
+
+    return begin;
+  }
+#endif
+}; // class ByteScanner
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
@@ -7,10 +7,9 @@
 // -----------------------------------------------------------------------------
 
 #include <functional>
-#include <regex>
 #include <string>
 
-#include "maddy/blockparser.h"
+#include "maddy/containerparser.h"
 
 // -----------------------------------------------------------------------------
 
@@ -23,7 +22,7 @@ namespace maddy {
  *
  * @class
  */
-class ChecklistParser : public BlockParser
+class ChecklistParser : public ContainerParser
 {
 public:
   /**
@@ -31,15 +30,15 @@ public:
    *
    * @method
    * @param {std::function<void(std::string&)>} parseLineCallback
-   * @param {std::function<std::shared_ptr<BlockParser>(const std::string&
-   * line)>} getBlockParserForLineCallback
+   * @param {std::function<BlockParser*(const std::string& line)>}
+   * getBlockParserForLineCallback
    */
   ChecklistParser(
     std::function<void(std::string&)> parseLineCallback,
-    std::function<std::shared_ptr<BlockParser>(const std::string& line)>
+    std::function<BlockParser*(const std::string& line)>
       getBlockParserForLineCallback
   )
-    : BlockParser(parseLineCallback, getBlockParserForLineCallback)
+    : ContainerParser(parseLineCallback, getBlockParserForLineCallback)
     , isStarted(false)
     , isFinished(false)
   {}
@@ -55,8 +54,9 @@ public:
    */
   static bool IsStartingLine(const std::string& line)
   {
-    static std::regex re(R"(^- \[[x| ]\] .*)");
-    return std::regex_match(line, re);
+    return line.size() >= 6 && line.compare(0, 3, "- [") == 0 &&
+           (line[3] == 'x' || line[3] == '|' || line[3] == ' ') &&
+           line.compare(4, 2, "] ") == 0 && hasNoLineBreakFrom(line, 6);
   }
 
   /**
@@ -67,53 +67,66 @@ public:
    */
   bool IsFinished() const override { return this->isFinished; }
 
-protected:
-  bool isInlineBlockAllowed() const override { return true; }
+  /**
+   * Reset
+   *
+   * @method
+   * @return {void}
+   */
+  void Reset() override
+  {
+    ContainerParser::Reset();
+    this->isStarted = false;
+    this->isFinished = false;
+  }
 
-  bool isLineParserAllowed() const override { return true; }
+protected:
+  size_t getChildIndentation() const override { return 2; }
 
-  void parseBlock(std::string& line) override
+  void parseContainerLine(ContainerLine& line) override
   {
-    bool isStartOfNewListItem = IsStartingLine(line);
-    uint32_t indentation = getIndentationWidth(line);
-
-    static std::regex lineRegex("^(- )");
-    line = std::regex_replace(line, lineRegex, "");
+    const bool isStartOfNewListItem =
+      line.GetSize() >= 6 && line.StartsWith("- [") &&
+      (line.At(3) == 'x' || line.At(3) == '|' || line.At(3) == ' ') &&
+      line.At(4) == ']' && line.At(5) == ' ' && line.HasNoLineBreakFrom(6);
+    const bool isNested = line.IsIndented(2);
 
-    static std::regex emptyBoxRegex(R"(^\[ \])");
-    static std::string emptyBoxReplacement = "<input type=\"checkbox\"/>";
-    line = std::regex_replace(line, emptyBoxRegex, emptyBoxReplacement);
+    line.ErasePrefix("- ");
 
-    static std::regex boxRegex(R"(^\[x\])");
-    static std::string boxReplacement =
-      "<input type=\"checkbox\" checked=\"checked\"/>";
-    line = std::regex_replace(line, boxRegex, boxReplacement);
+    if (line.ErasePrefix("[ ]"))
+    {
+      line.Insert("<input type=\"checkbox\"/>");
+    }
+    else if (line.ErasePrefix("[x]"))
+    {
+      line.Insert("<input type=\"checkbox\" checked=\"checked\"/>");
+    }
 
     if (!this->isStarted)
     {
-      line = "<ul class=\"checklist\"><li><label>" + line;
+      line.Insert("<ul class=\"checklist\"><li><label>");
       this->isStarted = true;
       return;
     }
 
-    if (indentation >= 2)
+    if (isNested)
     {
-      line = line.substr(2);
+      line.Erase(2);
       return;
     }
 
-    if (line.empty() ||
-        line.find("</label></li><li><label>") != std::string::npos ||
-        line.find("</label></li></ul>") != std::string::npos)
+    // the closing tags of a parent item close this list as well
+    if (line.IsEmpty() || line.IsItemClosed() ||
+        line.ContainsTag("</label></li>", {"<li><label>", "</ul>"}))
     {
-      line = "</label></li></ul>" + line;
+      line.CloseItem("</label></li></ul>");
       this->isFinished = true;
       return;
     }
 
     if (isStartOfNewListItem)
     {
-      line = "</label></li><li><label>" + line;
+      line.CloseItem("</label></li><li><label>");
     }
   }
 
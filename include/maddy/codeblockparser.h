@@ -6,11 +6,13 @@
 
 // -----------------------------------------------------------------------------
 
+#include <cstring>
 #include <functional>
-#include <regex>
 #include <string>
 
 #include "maddy/blockparser.h"
+#include "maddy/htmlescape.h"
+#include "maddy/syntaxhighlighter.h"
 
 // -----------------------------------------------------------------------------
 
@@ -37,6 +39,10 @@ namespace maddy {
  * </code></pre>
  * ```
  *
+ * `&`, `<` and `>` in the code are escaped. With highlighting enabled, the
+ * code of the languages of `SyntaxHighlighter` gets `<span class="hl-...">`
+ * markup.
+ *
  * @class
  */
 class CodeBlockParser : public BlockParser
@@ -47,17 +53,21 @@ public:
    *
    * @method
    * @param {std::function<void(std::string&)>} parseLineCallback
-   * @param {std::function<std::shared_ptr<BlockParser>(const std::string&
-   * line)>} getBlockParserForLineCallback
+   * @param {std::function<BlockParser*(const std::string& line)>}
+   * getBlockParserForLineCallback
+   * @param {bool} isHighlightingEnabled
    */
   CodeBlockParser(
     std::function<void(std::string&)> parseLineCallback,
-    std::function<std::shared_ptr<BlockParser>(const std::string& line)>
-      getBlockParserForLineCallback
+    std::function<BlockParser*(const std::string& line)>
+      getBlockParserForLineCallback,
+    bool isHighlightingEnabled = false
   )
     : BlockParser(parseLineCallback, getBlockParserForLineCallback)
     , isStarted(false)
     , isFinished(false)
+    , isHighlightingEnabled(isHighlightingEnabled)
+    , highlighter(nullptr)
   {}
 
   /**
@@ -75,8 +85,7 @@ public:
    */
   static bool IsStartingLine(const std::string& line)
   {
-    static std::regex re("^(?:`){3}(.*)$");
-    return std::regex_match(line, re);
+    return line.compare(0, 3, "```") == 0 && hasNoLineBreakFrom(line, 3);
   }
 
   /**
@@ -87,6 +96,75 @@ public:
    */
   bool IsFinished() const override { return this->isFinished; }
 
+  /**
+   * IsTakingVerbatimLines
+   *
+   * @method
+   * @return {bool}
+   */
+  bool IsTakingVerbatimLines() const override
+  {
+    return this->isStarted && !this->isFinished;
+  }
+
+  /**
+   * AddVerbatimLines
+   *
+   * Takes the lines up to the closing fence and escapes (or highlights) them
+   * in one go.
+   *
+   * @method
+   * @param {const char*} begin
+   * @param {const char*} end
+   * @param {size_t} maxLineLength
+   * @return {const char*}
+   */
+  const char* AddVerbatimLines(
+    const char* begin, const char* end, size_t maxLineLength
+  ) override
+  {
+    const char* current = begin;
+    // the lines since the last flush
+    const char* chunkBegin = begin;
+
+    while (current < end)
+    {
+      const char* lineEnd = findVerbatimLineEnd(current, end, maxLineLength);
+
+      if (!lineEnd ||
+          (lineEnd - current == 3 && std::memcmp(current, "```", 3) == 0))
+      {
+        break;
+      }
+
+      current = lineEnd + 1;
+
+      if (static_cast<size_t>(current - chunkBegin) >= VERBATIM_CHUNK_SIZE)
+      {
+        this->addVerbatimChunk(chunkBegin, current);
+        chunkBegin = current;
+      }
+    }
+
+    this->addVerbatimChunk(chunkBegin, current);
+
+    return current;
+  }
+
+  /**
+   * Reset
+   *
+   * @method
+   * @return {void}
+   */
+  void Reset() override
+  {
+    BlockParser::Reset();
+    this->isStarted = false;
+    this->isFinished = false;
+    this->highlighter = nullptr;
+  }
+
 protected:
   bool isInlineBlockAllowed() const override { return false; }
 
@@ -113,18 +191,84 @@ protected:
     }
     else if (!this->isStarted && line.substr(0, 3) == "```")
     {
-      line = "<pre class=\"" + line.substr(3) + "\"><code>\n";
+      const std::string infoString = line.substr(3);
+
+      if (this->isHighlightingEnabled)
+      {
+        this->highlighter = SyntaxHighlighter::Find(infoString);
+        this->highlightState = SyntaxHighlighter::State();
+      }
+
+      line = "<pre class=\"" + HtmlEscape::Escape(infoString) + "\"><code>\n";
       this->isStarted = true;
       this->isFinished = false;
       return;
     }
 
+    if (this->highlighter)
+    {
+      this->escapedLine.clear();
+      this->highlighter->Highlight(
+        line.data(), line.size(), this->highlightState, this->escapedLine
+      );
+      line.swap(this->escapedLine);
+    }
+    else
+    {
+      HtmlEscape::EscapeText(line, this->escapedLine);
+    }
+
     line += "\n";
   }
 
 private:
+  // the escaped code is appended to the result in parts of this size, which
+  // stay in the cache
+  enum : size_t
+  {
+    VERBATIM_CHUNK_SIZE = 64 * 1024
+  };
+
   bool isStarted;
   bool isFinished;
+  bool isHighlightingEnabled;
+  // nullptr for code without a known language
+  const SyntaxHighlighter* highlighter;
+  SyntaxHighlighter::State highlightState;
+  std::string escapedLine;
+
+  // complete lines, the line breaks are kept as they are
+  void addVerbatimChunk(const char* begin, const char* end)
+  {
+    this->escapedLine.clear();
+
+    if (!this->highlighter)
+    {
+      HtmlEscape::AppendText(
+        this->escapedLine, begin, static_cast<size_t>(end - begin)
+      );
+    }
+    else
+    {
+      for (const char* line = begin; line < end;)
+      {
+        const char* lineEnd = static_cast<const char*>(
+          std::memchr(line, '\n', static_cast<size_t>(end - line))
+        );
+
+        this->highlighter->Highlight(
+          line,
+          static_cast<size_t>(lineEnd - line),
+          this->highlightState,
+          this->escapedLine
+        );
+        this->escapedLine += '\n';
+        line = lineEnd + 1;
+      }
+    }
+
+    this->result.Append(this->escapedLine);
+  }
 }; // class CodeBlockParser
 
 // -----------------------------------------------------------------------------
@@ -0,0 +1,719 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+#include "maddy/blockparser.h"
+#include "maddy/bytescanner.h"
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * ContainerLine
+ *
+ * One line on its way down the nested lists and quotes of a
+ * `ContainerParser`. Instead of changing the line on every level, it keeps
+ * the original text and only moves the start of the content:
+ *
+ * - the markers and the indentation, which a level takes, are skipped by
+ *   moving the content offset
+ * - the tags, which a level writes in front of the line, are collected and
+ *   only written into the line, when a block has to read it (see `Apply`)
+ * - the spaces, which quotes add at the end, are only counted
+ *
+ * So a level costs the same for a line of any length. All tags start with
+ * `<`, which is not the first byte of any marker, so markers are only
+ * searched in the text behind the tags.
+ *
+ * @class
+ */
+class ContainerLine
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   */
+  ContainerLine()
+    : text(nullptr)
+    , offset(0)
+    , tagsSize(0)
+    , spaceCount(0)
+    , isItemClosed(false)
+    , lineBreakScanBegin(0)
+    , lineBreakEnd(0)
+    , isLineBreakEndKnown(false)
+    , searchedTag(nullptr)
+    , lastTagMatch(std::string::npos)
+  {}
+
+  /**
+   * Reset
+   *
+   * Starts the next line.
+   *
+   * @method
+   * @param {std::string&} line is only changed by `Apply`
+   * @return {void}
+   */
+  void Reset(std::string& line)
+  {
+    this->text = &line;
+    this->offset = 0;
+    this->tags.clear();
+    this->tagsSize = 0;
+    this->spaceCount = 0;
+    this->isItemClosed = false;
+    this->isLineBreakEndKnown = false;
+    this->searchedTag = nullptr;
+  }
+
+  /**
+   * GetSize
+   *
+   * @method
+   * @return {size_t}
+   */
+  size_t GetSize() const
+  {
+    return this->tagsSize + this->text->size() - this->offset +
+           this->spaceCount;
+  }
+
+  /**
+   * IsEmpty
+   *
+   * @method
+   * @return {bool}
+   */
+  bool IsEmpty() const { return this->GetSize() == 0; }
+
+  /**
+   * At
+   *
+   * @method
+   * @param {size_t} pos
+   * @return {char} the byte at `pos`, `\0` behind the end
+   */
+  char At(size_t pos) const
+  {
+    if (pos < this->tagsSize)
+    {
+      return this->tagAt(pos);
+    }
+
+    pos -= this->tagsSize;
+
+    const size_t textSize = this->text->size() - this->offset;
+
+    if (pos < textSize)
+    {
+      return (*this->text)[this->offset + pos];
+    }
+
+    return pos - textSize < this->spaceCount ? ' ' : '\0';
+  }
+
+  /**
+   * StartsWith
+   *
+   * @method
+   * @param {const char*} prefix
+   * @return {bool}
+   */
+  bool StartsWith(const char* prefix) const
+  {
+    const size_t length = std::char_traits<char>::length(prefix);
+
+    if (length > this->GetSize())
+    {
+      return false;
+    }
+
+    for (size_t i = 0; i < length; ++i)
+    {
+      if (this->At(i) != prefix[i])
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * IsIndented
+   *
+   * @method
+   * @param {size_t} width
+   * @return {bool} if the line starts with at least `width` whitespace bytes
+   */
+  bool IsIndented(size_t width) const
+  {
+    if (this->GetSize() < width)
+    {
+      return false;
+    }
+
+    for (size_t i = 0; i < width; ++i)
+    {
+      if (!std::isspace(static_cast<unsigned char>(this->At(i))))
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * CountIndentation
+   *
+   * @method
+   * @param {size_t} maxCount
+   * @return {size_t} number of whitespace bytes at the start of the line, at
+   * most `maxCount`
+   */
+  size_t CountIndentation(size_t maxCount) const
+  {
+    size_t count = 0;
+
+    while (count < maxCount &&
+           std::isspace(static_cast<unsigned char>(this->At(count))))
+    {
+      ++count;
+    }
+
+    return count;
+  }
+
+  /**
+   * CountDigits
+   *
+   * @method
+   * @return {size_t} number of digits at the start of the line
+   */
+  size_t CountDigits() const
+  {
+    size_t count = 0;
+
+    while (std::isdigit(static_cast<unsigned char>(this->At(count))))
+    {
+      ++count;
+    }
+
+    return count;
+  }
+
+  /**
+   * HasNoLineBreakFrom
+   *
+   * Same as `BlockParser::hasNoLineBreakFrom` for the whole line. The text
+   * is only searched once per line.
+   *
+   * @method
+   * @param {size_t} pos
+   * @return {bool}
+   */
+  bool HasNoLineBreakFrom(size_t pos) const
+  {
+    if (pos > this->GetSize())
+    {
+      return false;
+    }
+
+    // tags and the added spaces have no line breaks
+    const size_t textPos =
+      this->offset + (pos > this->tagsSize ? pos - this->tagsSize : 0);
+
+    // the content offset only grows, so the text in front of the first
+    // position is never asked for again
+    if (!this->isLineBreakEndKnown || textPos < this->lineBreakScanBegin)
+    {
+      static const ByteScanner lineBreakScanner("\r\n");
+
+      this->lineBreakScanBegin = textPos;
+      this->lineBreakEnd = textPos;
+
+      for (size_t lineBreak = lineBreakScanner.Find(*this->text, textPos);
+           lineBreak != std::string::npos;
+           lineBreak = lineBreakScanner.Find(*this->text, lineBreak + 1))
+      {
+        this->lineBreakEnd = lineBreak + 1;
+      }
+
+      this->isLineBreakEndKnown = true;
+    }
+
+    return textPos >= this->lineBreakEnd;
+  }
+
+  /**
+   * ContainsTag
+   *
+   * Checks if `tag` followed by one of `nextTags` is in the content of the
+   * line, e.g. the `</li><li>` of a list item, which was written in the
+   * Markdown. The tags, which are not applied yet, are not searched. The
+   * text is searched once per line and `tag`, later calls only compare the
+   * last match with the content offset.
+   *
+   * @method
+   * @param {const char*} tag
+   * @param {std::initializer_list<const char*>} nextTags the same for every
+   * call with this `tag`
+   * @return {bool}
+   */
+  bool ContainsTag(
+    const char* tag, std::initializer_list<const char*> nextTags
+  ) const
+  {
+    if (!this->searchedTag || std::strcmp(this->searchedTag, tag) != 0)
+    {
+      this->searchedTag = tag;
+      this->lastTagMatch = findLastTag(*this->text, tag, nextTags);
+    }
+
+    return this->lastTagMatch != std::string::npos &&
+           this->lastTagMatch >= this->offset;
+  }
+
+  /**
+   * ErasePrefix
+   *
+   * @method
+   * @param {const char*} prefix
+   * @return {bool} if the line started with the prefix
+   */
+  bool ErasePrefix(const char* prefix)
+  {
+    if (!this->StartsWith(prefix))
+    {
+      return false;
+    }
+
+    this->Erase(std::char_traits<char>::length(prefix));
+    return true;
+  }
+
+  /**
+   * Erase
+   *
+   * Removes bytes from the start of the line, which has no tags in front.
+   *
+   * @method
+   * @param {size_t} count
+   * @return {void}
+   */
+  void Erase(size_t count)
+  {
+    const size_t textCount =
+      std::min(count, this->text->size() - this->offset);
+
+    this->offset += textCount;
+    this->spaceCount -= std::min(count - textCount, this->spaceCount);
+  }
+
+  /**
+   * Insert
+   *
+   * Writes a tag in front of the line.
+   *
+   * @method
+   * @param {const char*} tag a string literal, which is not copied
+   * @return {void}
+   */
+  template <size_t N>
+  void Insert(const char (&tag)[N])
+  {
+    const Tag entry = {tag, N - 1};
+
+    this->tags.push_back(entry);
+    this->tagsSize += entry.size;
+  }
+
+  /**
+   * CloseItem
+   *
+   * Writes the tags, which close the current list item, in front of the
+   * line. Those tags close every open item below as well, see
+   * `IsItemClosed`.
+   *
+   * @method
+   * @param {const char*} tags a string literal, which is not copied
+   * @return {void}
+   */
+  template <size_t N>
+  void CloseItem(const char (&tags)[N])
+  {
+    this->Insert(tags);
+    this->isItemClosed = true;
+  }
+
+  /**
+   * IsItemClosed
+   *
+   * @method
+   * @return {bool} if a level above closed its list item in this line
+   */
+  bool IsItemClosed() const { return this->isItemClosed; }
+
+  /**
+   * AppendSpace
+   *
+   * @method
+   * @return {void}
+   */
+  void AppendSpace() { ++this->spaceCount; }
+
+  /**
+   * Apply
+   *
+   * Writes the tags in front of the content of the line and the spaces
+   * behind it, the line starts over with the result as its text. Later
+   * levels search the written tags as well, like they did when every level
+   * changed the line itself.
+   *
+   * @method
+   * @return {void}
+   */
+  void Apply()
+  {
+    if (this->tags.size() == 1)
+    {
+      this->text->replace(0, this->offset, this->tags[0].text, this->tagsSize);
+    }
+    else if (this->tags.empty())
+    {
+      this->text->erase(0, this->offset);
+    }
+    else
+    {
+      this->prefix.clear();
+
+      for (size_t i = this->tags.size(); i-- > 0;)
+      {
+        this->prefix.append(this->tags[i].text, this->tags[i].size);
+      }
+
+      this->text->replace(0, this->offset, this->prefix);
+    }
+
+    this->text->append(this->spaceCount, ' ');
+
+    this->offset = 0;
+    this->tags.clear();
+    this->tagsSize = 0;
+    this->spaceCount = 0;
+    this->isLineBreakEndKnown = false;
+    this->searchedTag = nullptr;
+  }
+
+private:
+  struct Tag
+  {
+    const char* text;
+    size_t size;
+  };
+
+  std::string* text;
+  // begin of the content in `text`
+  size_t offset;
+  // in the order they were inserted, so the last one is in front
+  std::vector<Tag> tags;
+  size_t tagsSize;
+  // only used by `Apply` for more than one tag
+  std::string prefix;
+  size_t spaceCount;
+  bool isItemClosed;
+  mutable size_t lineBreakScanBegin;
+  mutable size_t lineBreakEnd;
+  mutable bool isLineBreakEndKnown;
+  mutable const char* searchedTag;
+  mutable size_t lastTagMatch;
+
+  char tagAt(size_t pos) const
+  {
+    for (size_t i = this->tags.size(); i-- > 0;)
+    {
+      if (pos < this->tags[i].size)
+      {
+        return this->tags[i].text[pos];
+      }
+
+      pos -= this->tags[i].size;
+    }
+
+    return '\0';
+  }
+
+  static size_t findLastTag(
+    const std::string& text,
+    const char* tag,
+    std::initializer_list<const char*> nextTags
+  )
+  {
+    const size_t tagLength = std::char_traits<char>::length(tag);
+    size_t lastMatch = std::string::npos;
+
+    for (size_t pos = text.find(tag); pos != std::string::npos;
+         pos = text.find(tag, pos + 1))
+    {
+      for (const char* nextTag : nextTags)
+      {
+        if (text.compare(
+              pos + tagLength, std::char_traits<char>::length(nextTag), nextTag
+            ) == 0)
+        {
+          lastMatch = pos;
+          break;
+        }
+      }
+    }
+
+    return lastMatch;
+  }
+}; // class ContainerLine
+
+// -----------------------------------------------------------------------------
+
+/**
+ * ContainerParser
+ *
+ * Base of the blocks, which contain other blocks: lists, checklists and
+ * quotes. The top-level container parses the lines for all nested levels
+ * with one explicit stack of frames, one frame per open level, which is kept
+ * from line to line. A line is not handed down from level to level:
+ *
+ * - all frames take their markers from the same `ContainerLine`, so the line
+ *   is neither copied nor searched once per level
+ * - a list level, which has an open child list, only takes the indentation
+ *   of a nested line, so the indentation is counted once and the stack jumps
+ *   straight to the level of the line (list levels only contain lists)
+ * - on the way back only the levels, which got the line, and the level in
+ *   front of them check if their child is finished
+ *
+ * The innermost block gets the line, the HTML goes into the shared result
+ * (see `OutputBuffer`).
+ *
+ * @class
+ */
+class ContainerParser : public BlockParser
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   * @param {std::function<void(std::string&)>} parseLineCallback
+   * @param {std::function<BlockParser*(const std::string& line)>}
+   * getBlockParserForLineCallback
+   */
+  ContainerParser(
+    std::function<void(std::string&)> parseLineCallback,
+    std::function<BlockParser*(const std::string& line)>
+      getBlockParserForLineCallback
+  )
+    : BlockParser(parseLineCallback, getBlockParserForLineCallback)
+  {}
+
+  /**
+   * AddLine
+   *
+   * @method
+   * @param {std::string&} line
+   * @return {void}
+   */
+  void AddLine(std::string& line) override
+  {
+    if (this->frames.empty())
+    {
+      this->frames.push_back(this);
+    }
+
+    this->containerLine.Reset(line);
+    this->parentFrames.clear();
+
+    BlockParser* innermostBlock = nullptr;
+    bool isApplied = false;
+    size_t index = 0;
+
+    for (;;)
+    {
+      const size_t childIndentation =
+        this->frames[index]->getChildIndentation();
+
+      if (childIndentation > 0 && index + 1 < this->frames.size())
+      {
+        const size_t levels = std::min(
+          this->containerLine.CountIndentation(
+            childIndentation * (this->frames.size() - 1 - index)
+          ) / childIndentation,
+          this->frames.size() - 1 - index
+        );
+
+        if (levels > 0)
+        {
+          this->containerLine.Erase(childIndentation * levels);
+          index += levels;
+          // the only skipped level, whose child can be finished
+          this->parentFrames.push_back(index - 1);
+        }
+      }
+
+      ContainerParser* frame = this->frames[index];
+      frame->parseContainerLine(this->containerLine);
+
+      if (!frame->childParser)
+      {
+        this->containerLine.Apply();
+        isApplied = true;
+        frame->childParser = frame->getBlockParserForLine(line);
+      }
+
+      if (!frame->childParser)
+      {
+        break;
+      }
+
+      this->parentFrames.push_back(index);
+      ContainerParser* child = frame->childParser->asContainer();
+
+      if (!child)
+      {
+        innermostBlock = frame->childParser;
+        break;
+      }
+
+      isApplied = false;
+      ++index;
+
+      if (index == this->frames.size())
+      {
+        this->frames.push_back(child);
+      }
+    }
+
+    if (!isApplied)
+    {
+      this->containerLine.Apply();
+    }
+
+    if (innermostBlock)
+    {
+      innermostBlock->AddLine(line);
+    }
+    else
+    {
+      this->frames[index]->addContainerLine(line);
+    }
+
+    for (size_t i = this->parentFrames.size(); i-- > 0;)
+    {
+      this->frames[this->parentFrames[i]]->finishChildLine();
+    }
+
+    // drop the frames of the finished levels
+    for (const size_t parentIndex : this->parentFrames)
+    {
+      if (parentIndex + 1 < this->frames.size() &&
+          this->frames[parentIndex]->childParser !=
+            this->frames[parentIndex + 1])
+      {
+        this->frames.resize(parentIndex + 1);
+        break;
+      }
+    }
+  }
+
+  /**
+   * Reset
+   *
+   * @method
+   * @return {void}
+   */
+  void Reset() override
+  {
+    BlockParser::Reset();
+    this->frames.clear();
+  }
+
+protected:
+  bool isInlineBlockAllowed() const override { return true; }
+
+  bool isLineParserAllowed() const override { return true; }
+
+  ContainerParser* asContainer() override { return this; }
+
+  /**
+   * getChildIndentation
+   *
+   * @method
+   * @return {size_t} the indentation, which a nested line needs for every
+   * level, 0 if the child levels do not depend on indentation
+   */
+  virtual size_t getChildIndentation() const { return 0; }
+
+  /**
+   * parseContainerLine
+   *
+   * Takes the indentation or marker of this level from the line and writes
+   * the tags of this level in front of it.
+   *
+   * @method
+   * @param {ContainerLine&} line
+   * @return {void}
+   */
+  virtual void parseContainerLine(ContainerLine& line) = 0;
+
+  /**
+   * addContainerLine
+   *
+   * Adds the line to this level, if it has no child block.
+   *
+   * @method
+   * @param {std::string&} line
+   * @return {void}
+   */
+  virtual void addContainerLine(std::string& line)
+  {
+    this->parseLine(line);
+    this->result << line;
+  }
+
+  void parseBlock(std::string& line) override
+  {
+    ContainerLine blockLine;
+    blockLine.Reset(line);
+    this->parseContainerLine(blockLine);
+    blockLine.Apply();
+  }
+
+private:
+  // only used by the top-level container: the open levels from the top
+  // down, every frame is the child of the one before
+  std::vector<ContainerParser*> frames;
+  // frames, which had a child during the current line
+  std::vector<size_t> parentFrames;
+  ContainerLine containerLine;
+}; // class ContainerParser
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
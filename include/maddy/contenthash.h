@@ -0,0 +1,81 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <cstring>
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * ContentHash
+ *
+ * Fast 64 bit hash for Markdown source, e.g. to recognize unchanged blocks.
+ * It reads 8 bytes per step. It is not meant for persistent storage, the
+ * result depends on the byte order of the platform.
+ *
+ * @class
+ */
+class ContentHash
+{
+public:
+  /**
+   * Compute
+   *
+   * @method
+   * @param {const char*} data
+   * @param {size_t} size
+   * @param {uint64_t} seed
+   * @return {uint64_t}
+   */
+  static uint64_t Compute(const char* data, size_t size, uint64_t seed = 0)
+  {
+    uint64_t hash = seed ^ (static_cast<uint64_t>(size) * MULTIPLIER);
+
+    while (size >= sizeof(uint64_t))
+    {
+      uint64_t word;
+      std::memcpy(&word, data, sizeof(word));
+      hash = mix(hash ^ word);
+      data += sizeof(word);
+      size -= sizeof(word);
+    }
+
+    if (size > 0)
+    {
+      uint64_t word = 0;
+      std::memcpy(&word, data, size);
+      hash = mix(hash ^ word);
+    }
+
+    // final avalanche of MurmurHash3
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+
+    return hash;
+  }
+
+private:
+  static const uint64_t MULTIPLIER = 0x9e3779b97f4a7c15ULL;
+
+  static uint64_t mix(uint64_t hash)
+  {
+    hash *= MULTIPLIER;
+    return hash ^ (hash >> 32);
+  }
+}; // class ContentHash
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
@@ -0,0 +1,293 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <cctype>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "maddy/contenthash.h"
+#include "maddy/outputsink.h"
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * OutlineEntry
+ *
+ * One headline of a `DocumentOutline`.
+ *
+ * - `level`: 1 to 6
+ * - `text`: the HTML of the headline without tags, so character references
+ *   like `&amp;` are still escaped
+ * - `slug`: the `id` of the headline element, unique in the document
+ * - `sourceOffset`: begin of the line with the headline in the Markdown
+ * - `htmlOffset`: begin of the headline element in the written HTML, counted
+ *   from the first byte the parser wrote into the sink
+ *
+ * @class
+ */
+struct OutlineEntry
+{
+  uint32_t level;
+  std::string text;
+  std::string slug;
+  size_t sourceOffset;
+  size_t htmlOffset;
+}; // struct OutlineEntry
+
+// -----------------------------------------------------------------------------
+
+/**
+ * DocumentOutline
+ *
+ * All headlines of a document in document order, e.g. for a table of
+ * contents, which links to `#slug` or jumps straight to `htmlOffset`.
+ *
+ * @class
+ */
+class DocumentOutline
+{
+public:
+  /**
+   * GetEntries
+   *
+   * @method
+   * @return {const std::vector<OutlineEntry>&}
+   */
+  const std::vector<OutlineEntry>& GetEntries() const { return this->entries; }
+
+  /**
+   * Clear
+   *
+   * @method
+   * @return {void}
+   */
+  void Clear() { this->entries.clear(); }
+
+private:
+  friend class OutlineBuilder;
+
+  std::vector<OutlineEntry> entries;
+}; // class DocumentOutline
+
+// -----------------------------------------------------------------------------
+
+/**
+ * OutlineBuilder
+ *
+ * Builds a `DocumentOutline` while a document is parsed and hands out the
+ * slugs of the headlines. It is put in front of the real sink to know the
+ * offset of the HTML written so far.
+ *
+ * Slugs are made like GitHub does: the text of the headline is lowercased,
+ * spaces become `-`, ASCII punctuation except `-` and `_` is dropped, other
+ * UTF-8 characters are kept. A slug, which was already used, gets the suffix
+ * `-1`, `-2`, ...
+ *
+ * @class
+ */
+class OutlineBuilder : public OutputSink
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   * @param {DocumentOutline&} outline is cleared
+   * @param {OutputSink&} sink
+   */
+  OutlineBuilder(DocumentOutline& outline, OutputSink& sink)
+    : outline(outline)
+    , sink(sink)
+    , lineOffset(0)
+    , writtenSize(0)
+  {
+    this->outline.Clear();
+  }
+
+  /**
+   * BeginLine
+   *
+   * @method
+   * @param {size_t} offset in the Markdown
+   * @return {void}
+   */
+  void BeginLine(size_t offset) { this->lineOffset = offset; }
+
+  /**
+   * AddHeadline
+   *
+   * @method
+   * @param {uint32_t} level
+   * @param {const std::string&} html content of the headline element
+   * @param {size_t} blockOffset offset of the headline element in the HTML of
+   * the block, which is not written yet
+   * @return {const std::string&} the slug, valid until the next call
+   */
+  const std::string& AddHeadline(
+    uint32_t level, const std::string& html, size_t blockOffset
+  )
+  {
+    OutlineEntry entry = {
+      level, std::string(), std::string(), this->lineOffset, blockOffset
+    };
+
+    bool isInTag = false;
+
+    for (const char c : html)
+    {
+      if (c == '<' || c == '>')
+      {
+        isInTag = c == '<';
+      }
+      else if (!isInTag)
+      {
+        entry.text += c;
+      }
+    }
+
+    const size_t textEnd = entry.text.find_last_not_of(" \t\r");
+    entry.text.erase(textEnd == std::string::npos ? 0 : textEnd + 1);
+    entry.text.erase(0, entry.text.find_first_not_of(" \t\r"));
+    entry.slug = this->makeUnique(makeSlug(entry.text));
+    this->blockEntries.push_back(std::move(entry));
+
+    return this->blockEntries.back().slug;
+  }
+
+  /**
+   * Write
+   *
+   * The parser writes the HTML of a block at once, when it is finished.
+   *
+   * @method
+   * @param {const char*} data
+   * @param {size_t} size
+   * @return {void}
+   */
+  void Write(const char* data, size_t size) override
+  {
+    // headlines of children, which were dropped with the rest of the
+    // block, are behind the written HTML
+    for (OutlineEntry& entry : this->blockEntries)
+    {
+      if (entry.htmlOffset < size)
+      {
+        entry.htmlOffset += this->writtenSize;
+        this->outline.entries.push_back(std::move(entry));
+      }
+    }
+
+    this->blockEntries.clear();
+    this->sink.Write(data, size);
+    this->writtenSize += size;
+  }
+
+private:
+  DocumentOutline& outline;
+  OutputSink& sink;
+  size_t lineOffset;
+  size_t writtenSize;
+  // the headlines of the open block, `htmlOffset` is still relative to it,
+  // they are dropped, if the block is never written
+  std::vector<OutlineEntry> blockEntries;
+  // the hash of every slug handed out, with the next suffix to try for it,
+  // a hash collision only leads to an unneeded suffix
+  std::unordered_map<uint64_t, uint32_t> slugs;
+
+  static bool isReferenceName(char c)
+  {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '#';
+  }
+
+  static std::string makeSlug(const std::string& text)
+  {
+    std::string slug;
+    slug.reserve(text.size());
+
+    for (size_t i = 0; i < text.size(); ++i)
+    {
+      const unsigned char c = static_cast<unsigned char>(text[i]);
+
+      if (c == '&')
+      {
+        // character references like `&lt;` are punctuation
+        size_t end = i + 1;
+
+        while (end < text.size() && isReferenceName(text[end]))
+        {
+          ++end;
+        }
+
+        if (end > i + 1 && end < text.size() && text[end] == ';')
+        {
+          i = end;
+          continue;
+        }
+      }
+
+      if (c >= 'A' && c <= 'Z')
+      {
+        slug += static_cast<char>(c - 'A' + 'a');
+      }
+      else if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+               c == '-' || c == '_' || c >= 0x80)
+      {
+        slug += static_cast<char>(c);
+      }
+      else if (c == ' ')
+      {
+        slug += '-';
+      }
+    }
+
+    if (slug.empty())
+    {
+      slug = "section";
+    }
+
+    return slug;
+  }
+
+  std::string makeUnique(const std::string& slug)
+  {
+    // references into the map stay valid, when it grows
+    uint32_t& nextSuffix = this->slugs[hash(slug)];
+
+    if (nextSuffix == 0)
+    {
+      nextSuffix = 1;
+      return slug;
+    }
+
+    for (;;)
+    {
+      std::string candidate = slug + '-' + std::to_string(nextSuffix++);
+
+      if (this->slugs.emplace(hash(candidate), 1).second)
+      {
+        return candidate;
+      }
+    }
+  }
+
+  static uint64_t hash(const std::string& slug)
+  {
+    return ContentHash::Compute(slug.data(), slug.size());
+  }
+}; // class OutlineBuilder
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
@@ -0,0 +1,223 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstddef>
+
+#include "maddy/bytescanner.h"
+#include "maddy/parserconfig.h"
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * DocumentPlan
+ *
+ * The parsers, which can match anywhere in one document. Every parser needs
+ * at least one byte to match, e.g. a table `|`, a LaTeX block `$`, a
+ * checklist `-` and `[` and strike-through `~`. A single scan over the whole
+ * document finds which of these bytes occur at all, so the parsers of
+ * features the document does not use are skipped for every line, without
+ * changing the output.
+ *
+ * A default constructed plan allows every parser, e.g. for streams, whose
+ * content is not known in advance.
+ *
+ * @class
+ */
+class DocumentPlan
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   */
+  DocumentPlan()
+    : possibleParsers(maddy::types::ALL)
+  {}
+
+  /**
+   * Scan
+   *
+   * The scan stops as soon as all bytes were found, which happens early in
+   * most larger documents, that use a bit of everything.
+   *
+   * @method
+   * @param {const char*} markdown
+   * @param {size_t} size
+   * @return {DocumentPlan}
+   */
+  static DocumentPlan Scan(const char* markdown, size_t size)
+  {
+    // in the order of the `TRIGGER` bits
+    static const ByteScanner scanner("|$[~`!*_\r<#>-+1");
+
+    uint32_t triggers = 0;
+
+    for (size_t pos = 0; pos < size && triggers != ALL_TRIGGERS;
+         pos += SCAN_BLOCK_SIZE)
+    {
+      const size_t blockSize = std::min<size_t>(size - pos, SCAN_BLOCK_SIZE);
+      triggers |= scanner.Collect(markdown + pos, markdown + pos + blockSize);
+    }
+
+    DocumentPlan plan;
+    plan.possibleParsers = getPossibleParsers(triggers);
+
+    return plan;
+  }
+
+  /**
+   * GetPossibleParsers
+   *
+   * @method
+   * @return {uint32_t} the `maddy::types`, which can match
+   */
+  uint32_t GetPossibleParsers() const { return this->possibleParsers; }
+
+  /**
+   * HasInlineMarkup
+   *
+   * @method
+   * @return {bool} false, if no line of the document needs a line parser
+   */
+  bool HasInlineMarkup() const
+  {
+    return (this->possibleParsers & INLINE_PARSERS) != 0;
+  }
+
+  /**
+   * WithoutHtmlOnlyParsers
+   *
+   * The same plan without the line parsers and the syntax highlighting, e.g.
+   * for `ParseTree`. They only change the HTML inside of a block, never
+   * which blocks there are or where they end.
+   *
+   * @method
+   * @return {DocumentPlan}
+   */
+  DocumentPlan WithoutHtmlOnlyParsers() const
+  {
+    DocumentPlan plan;
+    plan.possibleParsers =
+      this->possibleParsers &
+      ~(INLINE_PARSERS | maddy::types::CODE_HIGHLIGHT_PARSER);
+
+    return plan;
+  }
+
+private:
+  enum TRIGGER : uint32_t
+  {
+    PIPE_TRIGGER = 0b1,
+    DOLLAR_TRIGGER = 0b10,
+    BRACKET_TRIGGER = 0b100,
+    TILDE_TRIGGER = 0b1000,
+    BACKTICK_TRIGGER = 0b10000,
+    EXCLAMATION_TRIGGER = 0b100000,
+    ASTERISK_TRIGGER = 0b1000000,
+    UNDERSCORE_TRIGGER = 0b10000000,
+    CARRIAGE_RETURN_TRIGGER = 0b100000000,
+    LESS_THAN_TRIGGER = 0b1000000000,
+    HASH_TRIGGER = 0b10000000000,
+    GREATER_THAN_TRIGGER = 0b100000000000,
+    MINUS_TRIGGER = 0b1000000000000,
+    PLUS_TRIGGER = 0b10000000000000,
+    ONE_TRIGGER = 0b100000000000000,
+
+    ALL_TRIGGERS = 0b111111111111111,
+  };
+
+  enum : uint32_t
+  {
+    // the parsers run by `InlineParser`
+    INLINE_PARSERS = maddy::types::BREAKLINE_PARSER |
+                     maddy::types::EMPHASIZED_PARSER |
+                     maddy::types::IMAGE_PARSER |
+                     maddy::types::INLINE_CODE_PARSER |
+                     maddy::types::ITALIC_PARSER | maddy::types::LINK_PARSER |
+                     maddy::types::STRIKETHROUGH_PARSER |
+                     maddy::types::STRONG_PARSER,
+
+    // parsers, which do not match bytes themselves
+    ALWAYS_POSSIBLE_PARSERS =
+      maddy::types::PARAGRAPH_PARSER | maddy::types::CODE_HIGHLIGHT_PARSER
+  };
+
+  // large enough to hide the per call setup of the scanner
+  enum : size_t
+  {
+    SCAN_BLOCK_SIZE = 16 * 1024
+  };
+
+  uint32_t possibleParsers;
+
+  static bool hasAll(uint32_t triggers, uint32_t required)
+  {
+    return (triggers & required) == required;
+  }
+
+  static uint32_t getPossibleParsers(uint32_t triggers)
+  {
+    uint32_t parsers = ALWAYS_POSSIBLE_PARSERS;
+
+    const struct
+    {
+      uint32_t required;
+      uint32_t parsers;
+    } rules[] = {
+      // `|table>` and pipe tables
+      {PIPE_TRIGGER,
+       maddy::types::TABLE_PARSER | maddy::types::PIPE_TABLE_PARSER},
+      // `$$`
+      {DOLLAR_TRIGGER, maddy::types::LATEX_BLOCK_PARSER},
+      // `- [ ] `
+      {MINUS_TRIGGER | BRACKET_TRIGGER, maddy::types::CHECKLIST_PARSER},
+      {TILDE_TRIGGER, maddy::types::STRIKETHROUGH_PARSER},
+      {BACKTICK_TRIGGER,
+       maddy::types::CODE_BLOCK_PARSER | maddy::types::INLINE_CODE_PARSER},
+      // `![`
+      {EXCLAMATION_TRIGGER | BRACKET_TRIGGER, maddy::types::IMAGE_PARSER},
+      {BRACKET_TRIGGER, maddy::types::LINK_PARSER},
+      {ASTERISK_TRIGGER,
+       maddy::types::ITALIC_PARSER | maddy::types::STRONG_PARSER |
+         maddy::types::UNORDERED_LIST_PARSER},
+      {UNDERSCORE_TRIGGER,
+       maddy::types::EMPHASIZED_PARSER | maddy::types::STRONG_PARSER},
+      {CARRIAGE_RETURN_TRIGGER, maddy::types::BREAKLINE_PARSER},
+      {LESS_THAN_TRIGGER, maddy::types::HTML_PARSER},
+      {HASH_TRIGGER, maddy::types::HEADLINE_PARSER},
+      {GREATER_THAN_TRIGGER, maddy::types::QUOTE_PARSER},
+      {MINUS_TRIGGER,
+       maddy::types::HORIZONTAL_LINE_PARSER |
+         maddy::types::UNORDERED_LIST_PARSER},
+      {PLUS_TRIGGER, maddy::types::UNORDERED_LIST_PARSER},
+      // `1. `
+      {ONE_TRIGGER, maddy::types::ORDERED_LIST_PARSER},
+    };
+
+    for (const auto& rule : rules)
+    {
+      if (hasAll(triggers, rule.required))
+      {
+        parsers |= rule.parsers;
+      }
+    }
+
+    return parsers;
+  }
+}; // class DocumentPlan
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
@@ -0,0 +1,235 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <cstring>
+#include <vector>
+
+#include "maddy/documenttree.h"
+#include "maddy/outputsink.h"
+#include "maddy/parser.h"
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * DocumentRenderer
+ *
+ * Turns a `DocumentTree` into some output.
+ *
+ * @class
+ */
+class DocumentRenderer
+{
+public:
+  /**
+   * dtor
+   *
+   * @method
+   */
+  virtual ~DocumentRenderer() {}
+
+  /**
+   * Render
+   *
+   * @method
+   * @param {const DocumentTree&} tree
+   * @param {OutputSink&} sink
+   * @return {void}
+   */
+  virtual void Render(const DocumentTree& tree, OutputSink& sink) = 0;
+}; // class DocumentRenderer
+
+// -----------------------------------------------------------------------------
+
+/**
+ * HtmlRenderer
+ *
+ * Writes the HTML of the tree, which is the same output as `Parser::Parse`.
+ * Each top-level block is rendered by the block parser of its node type (see
+ * `Parser::RenderTree`), so the tags come from the node and the text from
+ * its source range.
+ *
+ * @class
+ */
+class HtmlRenderer : public DocumentRenderer
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   * @param {const Parser&} parser which built the tree
+   * @param {const char*} markdown the parsed Markdown
+   */
+  HtmlRenderer(const Parser& parser, const char* markdown)
+    : parser(parser)
+    , markdown(markdown)
+  {}
+
+  void Render(const DocumentTree& tree, OutputSink& sink) override
+  {
+    this->parser.RenderTree(this->markdown, tree, sink);
+  }
+
+private:
+  const Parser& parser;
+  const char* markdown;
+}; // class HtmlRenderer
+
+// -----------------------------------------------------------------------------
+
+/**
+ * PlainTextRenderer
+ *
+ * Writes the text of all top-level blocks of the given types without their
+ * block markup, one line per line, e.g. for a search index. Headline hashes,
+ * quote and list markers and the fences of code and LaTeX blocks are
+ * removed, inline markup is kept.
+ *
+ * @class
+ */
+class PlainTextRenderer : public DocumentRenderer
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   * @param {const char*} markdown the parsed Markdown
+   * @param {uint32_t} blockTypes `maddy::types` of the blocks to write
+   */
+  PlainTextRenderer(const char* markdown, uint32_t blockTypes)
+    : markdown(markdown)
+    , blockTypes(blockTypes)
+  {}
+
+  void Render(const DocumentTree& tree, OutputSink& sink) override
+  {
+    const std::vector<DocumentNode>& nodes = tree.GetNodes();
+
+    if (nodes.empty())
+    {
+      return;
+    }
+
+    for (uint32_t i = nodes[0].firstChild; i != DocumentTree::NO_NODE;
+         i = nodes[i].nextSibling)
+    {
+      const DocumentNode& node = nodes[i];
+
+      if (node.kind == DocumentNode::BLOCK_NODE &&
+          (node.blockType & this->blockTypes) != 0)
+      {
+        this->renderBlock(node, sink);
+      }
+    }
+  }
+
+private:
+  const char* markdown;
+  uint32_t blockTypes;
+
+  void renderBlock(const DocumentNode& node, OutputSink& sink) const
+  {
+    const char* blockBegin = this->markdown + node.sourceOffset;
+    const char* blockEnd = blockBegin + node.sourceSize;
+    const char* current = blockBegin;
+
+    while (current <= blockEnd)
+    {
+      const char* lineEnd = static_cast<const char*>(
+        std::memchr(current, '\n', static_cast<size_t>(blockEnd - current))
+      );
+
+      if (!lineEnd)
+      {
+        lineEnd = blockEnd;
+      }
+
+      const char* text = current;
+
+      switch (node.blockType)
+      {
+        case maddy::types::CODE_BLOCK_PARSER:
+        case maddy::types::LATEX_BLOCK_PARSER:
+          // the opening and the closing line are only fences
+          if (current == blockBegin || lineEnd == blockEnd)
+          {
+            text = lineEnd;
+          }
+          break;
+        case maddy::types::HEADLINE_PARSER:
+          text = skip(text, lineEnd, "#");
+          text = skip(text, lineEnd, " ");
+          break;
+        case maddy::types::CHECKLIST_PARSER:
+        case maddy::types::ORDERED_LIST_PARSER:
+        case maddy::types::QUOTE_PARSER:
+        case maddy::types::UNORDERED_LIST_PARSER:
+          text = skipContainerMarkers(text, lineEnd);
+          break;
+        default:
+          break;
+      }
+
+      if (text < lineEnd)
+      {
+        sink.Write(text, static_cast<size_t>(lineEnd - text));
+        sink.Write("\n", 1);
+      }
+
+      current = lineEnd + 1;
+    }
+  }
+
+  static const char* skip(
+    const char* begin, const char* end, const char* characters
+  )
+  {
+    while (begin < end && std::strchr(characters, *begin))
+    {
+      ++begin;
+    }
+
+    return begin;
+  }
+
+  // indentation, quote markers and one list or checklist marker
+  static const char* skipContainerMarkers(const char* begin, const char* end)
+  {
+    begin = skip(begin, end, " \t>");
+    const char* digitsEnd = skip(begin, end, "0123456789");
+
+    if (digitsEnd != begin && end - digitsEnd >= 2 && digitsEnd[0] == '.' &&
+        digitsEnd[1] == ' ')
+    {
+      return digitsEnd + 2;
+    }
+
+    if (end - begin >= 2 && std::strchr("*+-", begin[0]) && begin[1] == ' ')
+    {
+      begin += 2;
+
+      if (end - begin >= 4 && begin[0] == '[' && begin[2] == ']' &&
+          begin[3] == ' ')
+      {
+        begin += 4;
+      }
+    }
+
+    return begin;
+  }
+}; // class PlainTextRenderer
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
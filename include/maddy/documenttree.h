@@ -0,0 +1,358 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "maddy/blockparser.h"
+#include "maddy/documentplan.h"
+#include "maddy/outputsink.h"
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * DocumentNode
+ *
+ * One node of a `DocumentTree`. Nodes refer to each other by their index in
+ * the node array.
+ *
+ * - `DOCUMENT_NODE`: the root, always at index 0
+ * - `BLOCK_NODE`: a block, `blockType` is the `maddy::types` value of its
+ *   block parser. Blocks inside of quotes and lists are children of them.
+ * - `TEXT_NODE`: a line, which exceeded the `ParserLimits` and was written
+ *   as escaped plain text, child of the top-level block it was added to or
+ *   of the document
+ *
+ * A block with the `UNFINISHED_FLAG` was written as far as it got, when the
+ * budget of the parse was used up.
+ *
+ * `sourceOffset` and `sourceSize` are the lines of the node in the parsed
+ * Markdown, from the begin of its first line to the end of its last line
+ * (without the line break).
+ *
+ * @class
+ */
+struct DocumentNode
+{
+  enum KIND : uint8_t
+  {
+    DOCUMENT_NODE,
+    BLOCK_NODE,
+    TEXT_NODE,
+  };
+
+  enum FLAG : uint8_t
+  {
+    UNFINISHED_FLAG = 0b1,
+  };
+
+  KIND kind;
+  uint8_t flags;
+  uint32_t blockType;
+  uint32_t parent;
+  uint32_t firstChild;
+  uint32_t nextSibling;
+  uint32_t sourceOffset;
+  uint32_t sourceSize;
+}; // struct DocumentNode
+
+// -----------------------------------------------------------------------------
+
+/**
+ * DocumentTree
+ *
+ * Flat tree of the blocks of a parsed document: all nodes are stored in one
+ * array in document order, so walking it is a linear scan. No HTML is kept,
+ * a node is only its block type and its source range, so the tree is much
+ * smaller than the HTML of the document. One parse can feed several
+ * renderers (see `DocumentRenderer`), e.g. HTML, plain text for a search
+ * index or statistics.
+ *
+ * The tree does not own the Markdown, the source offsets are only valid as
+ * long as the parsed buffer is. Offsets are 32 bit, so documents can be at
+ * most `MAX_SOURCE_SIZE` bytes large.
+ *
+ * @class
+ */
+class DocumentTree
+{
+public:
+  /**
+   * NO_NODE
+   *
+   * Index for a missing parent, child or sibling.
+   */
+  enum : uint32_t
+  {
+    NO_NODE = 0xffffffff
+  };
+
+  /**
+   * MAX_SOURCE_SIZE
+   *
+   * The largest document for `ParseTree`, whose offsets all fit into 32 bit.
+   */
+  enum : uint64_t
+  {
+    MAX_SOURCE_SIZE = 0xffffffffULL
+  };
+
+  /**
+   * GetNodes
+   *
+   * @method
+   * @return {const std::vector<DocumentNode>&}
+   */
+  const std::vector<DocumentNode>& GetNodes() const { return this->nodes; }
+
+  /**
+   * GetPlan
+   *
+   * The `DocumentPlan` of the parsed document, so that renderers can skip
+   * the same parsers as the parse did.
+   *
+   * @method
+   * @return {const DocumentPlan&}
+   */
+  const DocumentPlan& GetPlan() const { return this->plan; }
+
+  /**
+   * Clear
+   *
+   * @method
+   * @return {void}
+   */
+  void Clear()
+  {
+    this->nodes.clear();
+    this->plan = DocumentPlan();
+  }
+
+private:
+  friend class DocumentTreeBuilder;
+
+  std::vector<DocumentNode> nodes;
+  DocumentPlan plan;
+}; // class DocumentTree
+
+// -----------------------------------------------------------------------------
+
+/**
+ * DocumentTreeBuilder
+ *
+ * Builds a `DocumentTree` while a document is parsed. The parser reports
+ * every line and every block parser it starts, the builder is also the sink
+ * of the generated HTML, which is not needed for the tree.
+ *
+ * Block parsers do not report when they are finished. So before each line
+ * the builder closes all blocks, whose parser `IsFinished`.
+ *
+ * @class
+ */
+class DocumentTreeBuilder : public OutputSink
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   * @param {DocumentTree&} tree is cleared
+   * @param {const DocumentPlan&} plan of the parsed document
+   */
+  DocumentTreeBuilder(DocumentTree& tree, const DocumentPlan& plan)
+    : tree(tree)
+    , lineOffset(0)
+    , lineSize(0)
+  {
+    this->tree.Clear();
+    this->tree.plan = plan;
+    this->addNode(DocumentNode::DOCUMENT_NODE, 0, DocumentTree::NO_NODE);
+  }
+
+  /**
+   * BeginLine
+   *
+   * @method
+   * @param {size_t} offset in the Markdown
+   * @param {size_t} size without the line break
+   * @return {void}
+   */
+  void BeginLine(size_t offset, size_t size)
+  {
+    this->lineOffset = static_cast<uint32_t>(offset);
+    this->lineSize = static_cast<uint32_t>(size);
+
+    for (size_t depth = 0; depth < this->openBlocks.size(); ++depth)
+    {
+      if (this->openBlocks[depth].parser->IsFinished())
+      {
+        this->openBlocks.resize(depth);
+        break;
+      }
+    }
+  }
+
+  /**
+   * OpenBlock
+   *
+   * A block parser was started for the current line.
+   *
+   * @method
+   * @param {size_t} depth nesting level, 0 for top-level blocks
+   * @param {uint32_t} blockType
+   * @param {const BlockParser*} parser
+   * @return {void}
+   */
+  void OpenBlock(size_t depth, uint32_t blockType, const BlockParser* parser)
+  {
+    if (this->openBlocks.size() > depth)
+    {
+      this->openBlocks.resize(depth);
+    }
+
+    const uint32_t parent =
+      this->openBlocks.empty() ? 0 : this->openBlocks.back().node;
+    const uint32_t node =
+      this->addNode(DocumentNode::BLOCK_NODE, blockType, parent);
+    this->tree.nodes[node].sourceOffset = this->lineOffset;
+
+    OpenBlockEntry entry = {node, parser};
+    this->openBlocks.push_back(entry);
+  }
+
+  /**
+   * AddTextLine
+   *
+   * The current line is written as escaped plain text, into the open
+   * top-level block or, if there is none, directly into the document.
+   *
+   * @method
+   * @return {void}
+   */
+  void AddTextLine()
+  {
+    const uint32_t parent =
+      this->openBlocks.empty() ? 0 : this->openBlocks.front().node;
+    const uint32_t node = this->addNode(DocumentNode::TEXT_NODE, 0, parent);
+    this->tree.nodes[node].sourceOffset = this->lineOffset;
+    this->tree.nodes[node].sourceSize = this->lineSize;
+  }
+
+  /**
+   * AbortBlocks
+   *
+   * The open top-level block was written unfinished, because the budget is
+   * used up.
+   *
+   * @method
+   * @return {void}
+   */
+  void AbortBlocks()
+  {
+    if (!this->openBlocks.empty())
+    {
+      this->tree.nodes[this->openBlocks.front().node].flags |=
+        DocumentNode::UNFINISHED_FLAG;
+      this->openBlocks.clear();
+    }
+  }
+
+  /**
+   * EndLine
+   *
+   * Adds the current line to all open blocks.
+   *
+   * @method
+   * @return {void}
+   */
+  void EndLine()
+  {
+    const uint32_t lineEnd = this->lineOffset + this->lineSize;
+
+    for (const OpenBlockEntry& entry : this->openBlocks)
+    {
+      DocumentNode& block = this->tree.nodes[entry.node];
+      block.sourceSize = lineEnd - block.sourceOffset;
+    }
+
+    this->tree.nodes[0].sourceSize = lineEnd;
+  }
+
+  /**
+   * Write
+   *
+   * The HTML is rendered from the tree, so it is dropped here.
+   *
+   * @method
+   * @param {const char*} data
+   * @param {size_t} size
+   * @return {void}
+   */
+  void Write(const char* /* data */, size_t /* size */) override {}
+
+private:
+  struct OpenBlockEntry
+  {
+    uint32_t node;
+    const BlockParser* parser;
+  };
+
+  DocumentTree& tree;
+  std::vector<OpenBlockEntry> openBlocks;
+  // only needed while building, to append children in constant time
+  std::vector<uint32_t> lastChildren;
+  uint32_t lineOffset;
+  uint32_t lineSize;
+
+  uint32_t addNode(
+    DocumentNode::KIND kind, uint32_t blockType, uint32_t parent
+  )
+  {
+    const uint32_t index = static_cast<uint32_t>(this->tree.nodes.size());
+    DocumentNode node = {
+      kind,
+      0,
+      blockType,
+      parent,
+      DocumentTree::NO_NODE,
+      DocumentTree::NO_NODE,
+      0,
+      0
+    };
+
+    this->tree.nodes.push_back(node);
+    this->lastChildren.push_back(DocumentTree::NO_NODE);
+
+    if (parent != DocumentTree::NO_NODE)
+    {
+      const uint32_t lastChild = this->lastChildren[parent];
+
+      if (lastChild == DocumentTree::NO_NODE)
+      {
+        this->tree.nodes[parent].firstChild = index;
+      }
+      else
+      {
+        this->tree.nodes[lastChild].nextSibling = index;
+      }
+
+      this->lastChildren[parent] = index;
+    }
+
+    return index;
+  }
+}; // class DocumentTreeBuilder
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
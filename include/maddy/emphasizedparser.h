@@ -6,9 +6,9 @@
 
 // -----------------------------------------------------------------------------
 
-#include <regex>
 #include <string>
 
+#include "maddy/inlineparser.h"
 #include "maddy/lineparser.h"
 
 // -----------------------------------------------------------------------------
@@ -40,12 +40,7 @@ public:
    */
   void Parse(std::string& line) override
   {
-    static std::regex re(
-      R"((?!.*`.*|.*<code>.*)_(?!.*`.*|.*<\/code>.*)([^_]*)_(?!.*`.*|.*<\/code>.*))"
-    );
-    static std::string replacement = "<em>$1</em>";
-
-    line = std::regex_replace(line, re, replacement);
+    InlineParser::ParseEmphasized(line);
   }
 }; // class EmphasizedParser
 
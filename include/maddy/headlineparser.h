@@ -6,11 +6,13 @@
 
 // -----------------------------------------------------------------------------
 
+#include <cstddef>
+#include <cstring>
 #include <functional>
-#include <regex>
 #include <string>
 
 #include "maddy/blockparser.h"
+#include "maddy/documentoutline.h"
 
 // -----------------------------------------------------------------------------
 
@@ -43,6 +45,9 @@ namespace maddy {
  * <h6>Headline 6</h6>
  * ```
  *
+ * With an `OutlineBuilder`, every headline gets a unique `id` (e.g.
+ * `<h1 id="headline-1">`) and is added to the outline.
+ *
  * @class
  */
 class HeadlineParser : public BlockParser
@@ -53,17 +58,23 @@ public:
    *
    * @method
    * @param {std::function<void(std::string&)>} parseLineCallback
-   * @param {std::function<std::shared_ptr<BlockParser>(const std::string&
-   * line)>} getBlockParserForLineCallback
+   * @param {std::function<BlockParser*(const std::string& line)>}
+   * getBlockParserForLineCallback
+   * @param {bool} isInlineParserAllowed
+   * @param {OutlineBuilder*} outlineBuilder optional
    */
   HeadlineParser(
     std::function<void(std::string&)> parseLineCallback,
-    std::function<std::shared_ptr<BlockParser>(const std::string& line)>
+    std::function<BlockParser*(const std::string& line)>
       getBlockParserForLineCallback,
-    bool isInlineParserAllowed = true
+    bool isInlineParserAllowed = true,
+    OutlineBuilder* outlineBuilder = nullptr
   )
     : BlockParser(parseLineCallback, getBlockParserForLineCallback)
     , isInlineParserAllowed(isInlineParserAllowed)
+    , outlineBuilder(outlineBuilder)
+    , level(0)
+    , openingTagOffset(0)
   {}
 
   /**
@@ -77,8 +88,10 @@ public:
    */
   static bool IsStartingLine(const std::string& line)
   {
-    static std::regex re("^(?:#){1,6} (.*)");
-    return std::regex_match(line, re);
+    const size_t level = line.find_first_not_of('#');
+
+    return level >= 1 && level <= 6 && line[level] == ' ' &&
+           hasNoLineBreakFrom(line, level + 1);
   }
 
   /**
@@ -92,6 +105,24 @@ public:
    */
   bool IsFinished() const override { return true; }
 
+  /**
+   * AddLine
+   *
+   * @method
+   * @param {std::string&} line
+   * @return {void}
+   */
+  void AddLine(std::string& line) override
+  {
+    this->level = 0;
+    BlockParser::AddLine(line);
+
+    if (this->outlineBuilder && this->level != 0)
+    {
+      this->addToOutline();
+    }
+  }
+
 protected:
   bool isInlineBlockAllowed() const override { return false; }
 
@@ -102,31 +133,80 @@ protected:
 
   void parseBlock(std::string& line) override
   {
-    static std::vector<std::regex> hlRegex = {
-      std::regex("^# (.*)"),
-      std::regex("^(?:#){2} (.*)"),
-      std::regex("^(?:#){3} (.*)"),
-      std::regex("^(?:#){4} (.*)"),
-      std::regex("^(?:#){5} (.*)"),
-      std::regex("^(?:#){6} (.*)")
-    };
-    static std::vector<std::string> hlReplacement = {
-      "<h1>$1</h1>",
-      "<h2>$1</h2>",
-      "<h3>$1</h3>",
-      "<h4>$1</h4>",
-      "<h5>$1</h5>",
-      "<h6>$1</h6>"
-    };
-
-    for (uint8_t i = 0; i < 6; ++i)
+    // same as `^(?:#){1,6} (.*)` -> `<hN>$1</hN>`, the opening tag is written
+    // directly into the result
+    const size_t level = line.find_first_not_of('#');
+
+    if (level < 1 || level > 6 || line[level] != ' ')
+    {
+      return;
+    }
+
+    const char levelDigit = static_cast<char>('0' + level);
+    size_t contentEnd = line.find_first_of("\r\n", level + 1);
+
+    if (contentEnd == std::string::npos)
     {
-      line = std::regex_replace(line, hlRegex[i], hlReplacement[i]);
+      contentEnd = line.size();
     }
+
+    const char openingTag[] = {'<', 'h', levelDigit, '>'};
+    const char closingTag[] = {'<', '/', 'h', levelDigit, '>'};
+
+    this->level = level;
+    this->openingTagOffset = this->result.GetSize();
+    this->result.Append(openingTag, sizeof(openingTag));
+    line.insert(contentEnd, closingTag, sizeof(closingTag));
+    line.erase(0, level + 1);
   }
 
 private:
   bool isInlineParserAllowed;
+  OutlineBuilder* outlineBuilder;
+  size_t level;
+  size_t openingTagOffset;
+  std::string content;
+
+  // the content is only known after the inline parsing, so the element is
+  // written again with its `id`
+  void addToOutline()
+  {
+    const char levelDigit = static_cast<char>('0' + this->level);
+    const char openingTag[] = {'<', 'h', levelDigit};
+    const char closingTag[] = {'<', '/', 'h', levelDigit, '>'};
+    // behind `<hN>`
+    const size_t contentBegin = this->openingTagOffset + sizeof(openingTag) + 1;
+    const size_t size = this->result.GetSize();
+
+    if (size < contentBegin + sizeof(closingTag) ||
+        std::memcmp(
+          this->result.GetData() + size - sizeof(closingTag),
+          closingTag,
+          sizeof(closingTag)
+        ) != 0)
+    {
+      return;
+    }
+
+    const size_t contentEnd = size - sizeof(closingTag);
+    this->content.assign(
+      this->result.GetData() + contentBegin, contentEnd - contentBegin
+    );
+
+    const std::string& slug = this->outlineBuilder->AddHeadline(
+      static_cast<uint32_t>(this->level),
+      this->content,
+      this->openingTagOffset
+    );
+
+    this->result.Truncate(this->openingTagOffset);
+    this->result.Append(openingTag, sizeof(openingTag));
+    this->result << " id=\"";
+    this->result << slug;
+    this->result << "\">";
+    this->result << this->content;
+    this->result.Append(closingTag, sizeof(closingTag));
+  }
 }; // class HeadlineParser
 
 // -----------------------------------------------------------------------------
@@ -7,7 +7,6 @@
 // -----------------------------------------------------------------------------
 
 #include <functional>
-#include <regex>
 #include <string>
 
 #include "maddy/blockparser.h"
@@ -35,16 +34,15 @@ public:
    *
    * @method
    * @param {std::function<void(std::string&)>} parseLineCallback
-   * @param {std::function<std::shared_ptr<BlockParser>(const std::string&
-   * line)>} getBlockParserForLineCallback
+   * @param {std::function<BlockParser*(const std::string& line)>}
+   * getBlockParserForLineCallback
    */
   HorizontalLineParser(
     std::function<void(std::string&)> parseLineCallback,
-    std::function<std::shared_ptr<BlockParser>(const std::string& line)>
+    std::function<BlockParser*(const std::string& line)>
       getBlockParserForLineCallback
   )
     : BlockParser(parseLineCallback, getBlockParserForLineCallback)
-    , lineRegex("^---$")
   {}
 
   /**
@@ -58,8 +56,7 @@ public:
    */
   static bool IsStartingLine(const std::string& line)
   {
-    static std::regex re("^---$");
-    return std::regex_match(line, re);
+    return line == "---";
   }
 
   /**
@@ -80,13 +77,11 @@ protected:
 
   void parseBlock(std::string& line) override
   {
-    static std::string replacement = "<hr/>";
-
-    line = std::regex_replace(line, lineRegex, replacement);
+    if (IsStartingLine(line))
+    {
+      line = "<hr/>";
+    }
   }
-
-private:
-  std::regex lineRegex;
 }; // class HorizontalLineParser
 
 // -----------------------------------------------------------------------------
@@ -0,0 +1,180 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <cstddef>
+#include <string>
+
+#include "maddy/bytescanner.h"
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * HtmlEscape
+ *
+ * Escapes text, so that it is shown as is in HTML: `&`, `<`, `>`, `"` and
+ * `'` are replaced by character references. The `Text` variants only replace
+ * `&`, `<` and `>`, which is enough for the content of an element, e.g. code,
+ * and leaves the quotes of source code untouched.
+ *
+ * The text is searched for the next byte to replace with `ByteScanner`, the
+ * spans in between are copied as a whole.
+ *
+ * @class
+ */
+class HtmlEscape
+{
+public:
+  /**
+   * Append
+   *
+   * Appends the escaped text to `output`.
+   *
+   * @method
+   * @param {std::string&} output
+   * @param {const char*} data
+   * @param {size_t} size
+   * @return {void}
+   */
+  static void Append(std::string& output, const char* data, size_t size)
+  {
+    append(getScanner(), output, data, size);
+  }
+
+  /**
+   * Escape
+   *
+   * @method
+   * @param {const std::string&} text
+   * @return {std::string}
+   */
+  static std::string Escape(const std::string& text)
+  {
+    std::string output;
+    output.reserve(text.size());
+    Append(output, text.data(), text.size());
+
+    return output;
+  }
+
+  /**
+   * AppendText
+   *
+   * Appends the text with `&`, `<` and `>` escaped to `output`.
+   *
+   * @method
+   * @param {std::string&} output
+   * @param {const char*} data
+   * @param {size_t} size
+   * @return {void}
+   */
+  static void AppendText(std::string& output, const char* data, size_t size)
+  {
+    append(getTextScanner(), output, data, size);
+  }
+
+  /**
+   * EscapeText
+   *
+   * Escapes `&`, `<` and `>` in place. A text without them is not touched,
+   * otherwise it is swapped with `buffer`, so that passing the same buffer
+   * for every line avoids allocations.
+   *
+   * @method
+   * @param {std::string&} text
+   * @param {std::string&} buffer
+   * @return {void}
+   */
+  static void EscapeText(std::string& text, std::string& buffer)
+  {
+    const size_t pos = getTextScanner().Find(text);
+
+    if (pos == std::string::npos)
+    {
+      return;
+    }
+
+    buffer.assign(text, 0, pos);
+    AppendText(buffer, text.data() + pos, text.size() - pos);
+    text.swap(buffer);
+  }
+
+  /**
+   * IsTextEscaped
+   *
+   * @method
+   * @param {const char*} data
+   * @param {size_t} size
+   * @return {bool} if there is no `&`, `<` or `>` in the text
+   */
+  static bool IsTextEscaped(const char* data, size_t size)
+  {
+    return getTextScanner().Find(data, data + size) == data + size;
+  }
+
+private:
+  static const ByteScanner& getScanner()
+  {
+    static const ByteScanner scanner("&<>\"'");
+    return scanner;
+  }
+
+  static const ByteScanner& getTextScanner()
+  {
+    static const ByteScanner scanner("&<>");
+    return scanner;
+  }
+
+  static void append(
+    const ByteScanner& scanner,
+    std::string& output,
+    const char* data,
+    size_t size
+  )
+  {
+    const char* end = data + size;
+
+    for (;;)
+    {
+      const char* found = scanner.Find(data, end);
+      output.append(data, static_cast<size_t>(found - data));
+
+      if (found == end)
+      {
+        return;
+      }
+
+      output += getReference(*found);
+      data = found + 1;
+    }
+  }
+
+  static const char* getReference(char c)
+  {
+    switch (c)
+    {
+      case '&':
+        return "&amp;";
+      case '<':
+        return "&lt;";
+      case '>':
+        return "&gt;";
+      case '"':
+        return "&quot;";
+      default:
+        return "&#39;";
+    }
+  }
+}; // class HtmlEscape
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
@@ -30,12 +30,12 @@ public:
    *
    * @method
    * @param {std::function<void(std::string&)>} parseLineCallback
-   * @param {std::function<std::shared_ptr<BlockParser>(const std::string&
-   * line)>} getBlockParserForLineCallback
+   * @param {std::function<BlockParser*(const std::string& line)>}
+   * getBlockParserForLineCallback
    */
   HtmlParser(
     std::function<void(std::string&)> parseLineCallback,
-    std::function<std::shared_ptr<BlockParser>(const std::string& line)>
+    std::function<BlockParser*(const std::string& line)>
       getBlockParserForLineCallback
   )
     : BlockParser(parseLineCallback, getBlockParserForLineCallback)
@@ -66,6 +66,75 @@ public:
    */
   bool IsFinished() const override { return this->isFinished; }
 
+  /**
+   * IsTakingVerbatimLines
+   *
+   * @method
+   * @return {bool}
+   */
+  bool IsTakingVerbatimLines() const override
+  {
+    return this->isStarted && !this->isFinished;
+  }
+
+  /**
+   * AddVerbatimLines
+   *
+   * Copies the lines up to the empty line, which ends the block. Lines are
+   * joined with a space, except behind a `>`.
+   *
+   * @method
+   * @param {const char*} begin
+   * @param {const char*} end
+   * @param {size_t} maxLineLength
+   * @return {const char*}
+   */
+  const char* AddVerbatimLines(
+    const char* begin, const char* end, size_t maxLineLength
+  ) override
+  {
+    const char* current = begin;
+
+    while (current < end)
+    {
+      const char* lineEnd = findVerbatimLineEnd(current, end, maxLineLength);
+
+      if (!lineEnd || (lineEnd == current && this->isGreaterThanFound))
+      {
+        break;
+      }
+
+      if (lineEnd != current)
+      {
+        this->isGreaterThanFound = lineEnd[-1] == '>';
+        this->result.Append(current, static_cast<size_t>(lineEnd - current));
+
+        if (!this->isGreaterThanFound)
+        {
+          this->result << " ";
+        }
+      }
+
+      current = lineEnd + 1;
+    }
+
+    return current;
+  }
+
+  /**
+   * Reset
+   *
+   * @method
+   * @return {void}
+   */
+  void Reset() override
+  {
+    BlockParser::Reset();
+    this->isStarted = false;
+    this->isFinished = false;
+    this->isGreaterThanFound = false;
+  }
+
 protected:
   bool isInlineBlockAllowed() const override { return false; }
 
@@ -6,9 +6,9 @@
 
 // -----------------------------------------------------------------------------
 
-#include <regex>
 #include <string>
 
+#include "maddy/inlineparser.h"
 #include "maddy/lineparser.h"
 
 // -----------------------------------------------------------------------------
@@ -40,10 +40,7 @@ public:
    */
   void Parse(std::string& line) override
   {
-    static std::regex re(R"(\!\[([^\]]*)\]\(([^\]]*)\))");
-    static std::string replacement = "<img src=\"$2\" alt=\"$1\"/>";
-
-    line = std::regex_replace(line, re, replacement);
+    InlineParser::ParseImages(line);
   }
 }; // class ImageParser
 
@@ -0,0 +1,393 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "maddy/contenthash.h"
+#include "maddy/outputsink.h"
+#include "maddy/parser.h"
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * IncrementalParser
+ *
+ * Keeps the blocks of the last parsed version of a document, so that a new
+ * version only has to be parsed from the first changed block on.
+ *
+ * A block is the source between two points, at which the parser has no open
+ * block, together with its HTML. Every block stores a `ContentHash` of its
+ * source. On `Update` the unchanged blocks at the start and at the end of
+ * the document are found by their hashes. Parsing starts behind the
+ * unchanged start and stops as soon as it reaches the begin of one of the
+ * unchanged blocks at the end, because from there on the parser would
+ * produce the same blocks again. So also blocks after the edit, which are
+ * affected by it (e.g. when a code fence was opened), are parsed again.
+ *
+ * The result is always the same as `Parser::Parse` of the whole document.
+ * The `Parser` has to outlive the `IncrementalParser`.
+ *
+ * ```
+ * maddy::IncrementalParser incrementalParser(parser);
+ * for (const auto& change : incrementalParser.Update(markdown))
+ * {
+ *   // replace change.removedHtmlSize bytes at change.htmlOffset with the
+ *   // HTML of the inserted blocks
+ * }
+ * ```
+ *
+ * @class
+ */
+class IncrementalParser
+{
+public:
+  /**
+   * Block
+   *
+   * One top-level block of the document.
+   */
+  struct Block
+  {
+    size_t sourceOffset;
+    size_t sourceSize;
+    uint64_t hash;
+    // finished at a line break and not only by the end of the document
+    bool isClosed;
+    std::string html;
+  };
+
+  /**
+   * Change
+   *
+   * The blocks `[firstBlock, firstBlock + removedBlockCount)` of the previous
+   * version were replaced by `[firstBlock, firstBlock + insertedBlockCount)`
+   * of `GetBlocks`. In the HTML this replaces `removedHtmlSize` bytes at
+   * `htmlOffset` with `insertedHtmlSize` bytes.
+   */
+  struct Change
+  {
+    size_t firstBlock;
+    size_t removedBlockCount;
+    size_t insertedBlockCount;
+    size_t htmlOffset;
+    size_t removedHtmlSize;
+    size_t insertedHtmlSize;
+  };
+
+  /**
+   * ctor
+   *
+   * @method
+   * @param {const Parser&} parser
+   */
+  explicit IncrementalParser(const Parser& parser)
+    : parser(parser)
+    , documentSize(0)
+  {}
+
+  /**
+   * Update
+   *
+   * Parses the new version of the document.
+   *
+   * @method
+   * @param {const char*} markdown
+   * @param {size_t} size
+   * @return {const std::vector<Change>&} empty, if nothing changed
+   */
+  const std::vector<Change>& Update(const char* markdown, size_t size)
+  {
+    this->changes.clear();
+
+    // unchanged blocks at the start
+    size_t firstBlock = 0;
+    size_t parseBegin = 0;
+
+    while (firstBlock < this->blocks.size())
+    {
+      const Block& block = this->blocks[firstBlock];
+
+      if (!block.isClosed || block.sourceOffset + block.sourceSize > size ||
+          !hasSameSource(block, markdown + block.sourceOffset))
+      {
+        break;
+      }
+
+      parseBegin = block.sourceOffset + block.sourceSize;
+      ++firstBlock;
+    }
+
+    if (firstBlock == this->blocks.size() && parseBegin == size &&
+        this->documentSize == size)
+    {
+      return this->changes;
+    }
+
+    // unchanged blocks at the end, they move with the size difference
+    size_t lastBlock = this->blocks.size();
+
+    while (lastBlock > firstBlock)
+    {
+      const Block& block = this->blocks[lastBlock - 1];
+
+      if (block.sourceOffset + size < parseBegin + this->documentSize ||
+          !hasSameSource(block, markdown + this->getNewOffset(block, size)))
+      {
+        break;
+      }
+
+      --lastBlock;
+    }
+
+    std::vector<Block> insertedBlocks;
+    const size_t resyncBlock = this->parseBlocks(
+      markdown, size, parseBegin, lastBlock, insertedBlocks
+    );
+
+    Change change;
+    change.firstBlock = firstBlock;
+    change.removedBlockCount = resyncBlock - firstBlock;
+    change.insertedBlockCount = insertedBlocks.size();
+    change.htmlOffset = getHtmlSize(0, firstBlock);
+    change.removedHtmlSize = getHtmlSize(firstBlock, resyncBlock);
+    change.insertedHtmlSize = 0;
+
+    for (const Block& block : insertedBlocks)
+    {
+      change.insertedHtmlSize += block.html.size();
+    }
+
+    for (size_t i = resyncBlock; i < this->blocks.size(); ++i)
+    {
+      this->blocks[i].sourceOffset =
+        this->getNewOffset(this->blocks[i], size);
+    }
+
+    this->blocks.erase(
+      this->blocks.begin() + static_cast<std::ptrdiff_t>(firstBlock),
+      this->blocks.begin() + static_cast<std::ptrdiff_t>(resyncBlock)
+    );
+    this->blocks.insert(
+      this->blocks.begin() + static_cast<std::ptrdiff_t>(firstBlock),
+      std::make_move_iterator(insertedBlocks.begin()),
+      std::make_move_iterator(insertedBlocks.end())
+    );
+    this->documentSize = size;
+    this->changes.push_back(change);
+
+    return this->changes;
+  }
+
+  /**
+   * Update
+   *
+   * @method
+   * @param {const std::string&} markdown
+   * @return {const std::vector<Change>&}
+   */
+  const std::vector<Change>& Update(const std::string& markdown)
+  {
+    return this->Update(markdown.data(), markdown.size());
+  }
+
+  /**
+   * GetBlocks
+   *
+   * @method
+   * @return {const std::vector<Block>&}
+   */
+  const std::vector<Block>& GetBlocks() const { return this->blocks; }
+
+  /**
+   * GetHtml
+   *
+   * @method
+   * @return {std::string} the HTML of the whole document
+   */
+  std::string GetHtml() const
+  {
+    std::string html;
+    html.reserve(getHtmlSize(0, this->blocks.size()));
+
+    for (const Block& block : this->blocks)
+    {
+      html += block.html;
+    }
+
+    return html;
+  }
+
+  /**
+   * WriteTo
+   *
+   * Writes the HTML of the whole document into the sink.
+   *
+   * @method
+   * @param {OutputSink&} sink
+   * @return {void}
+   */
+  void WriteTo(OutputSink& sink) const
+  {
+    for (const Block& block : this->blocks)
+    {
+      if (!block.html.empty())
+      {
+        sink.Write(block.html.data(), block.html.size());
+      }
+    }
+  }
+
+  /**
+   * Clear
+   *
+   * Forgets the previous version, so the next `Update` parses everything.
+   *
+   * @method
+   * @return {void}
+   */
+  void Clear()
+  {
+    this->blocks.clear();
+    this->changes.clear();
+    this->documentSize = 0;
+  }
+
+private:
+  const Parser& parser;
+  std::vector<Block> blocks;
+  std::vector<Change> changes;
+  size_t documentSize;
+
+  static bool hasSameSource(const Block& block, const char* source)
+  {
+    return ContentHash::Compute(source, block.sourceSize) == block.hash;
+  }
+
+  size_t getNewOffset(const Block& block, size_t newDocumentSize) const
+  {
+    return block.sourceOffset + newDocumentSize - this->documentSize;
+  }
+
+  size_t getHtmlSize(size_t begin, size_t end) const
+  {
+    size_t size = 0;
+
+    for (size_t i = begin; i < end; ++i)
+    {
+      size += this->blocks[i].html.size();
+    }
+
+    return size;
+  }
+
+  /**
+   * parseBlocks
+   *
+   * Parses from `begin` on, until a block ends where one of the old blocks
+   * from `firstUnchangedBlock` on begins in the new document.
+   *
+   * @return {size_t} the index of that old block, or the number of blocks
+   */
+  size_t parseBlocks(
+    const char* markdown,
+    size_t size,
+    size_t begin,
+    size_t firstUnchangedBlock,
+    std::vector<Block>& result
+  ) const
+  {
+    std::string html;
+    StringOutputSink sink(html);
+    std::unique_ptr<ParserSession> session = this->parser.CreateSession(sink);
+    std::string line;
+    size_t blockBegin = begin;
+    size_t current = begin;
+    size_t unchangedBlock = firstUnchangedBlock;
+
+    while (current < size)
+    {
+      const char* lineEnd = static_cast<const char*>(
+        std::memchr(markdown + current, '\n', size - current)
+      );
+      const bool hasLineBreak = lineEnd != nullptr;
+
+      if (!hasLineBreak)
+      {
+        lineEnd = markdown + size;
+      }
+
+      line.assign(markdown + current, lineEnd);
+      session->AddLine(line);
+      current = hasLineBreak ? (lineEnd - markdown) + 1 : size;
+
+      if (session->HasOpenBlock())
+      {
+        continue;
+      }
+
+      result.push_back(
+        makeBlock(markdown, blockBegin, current, hasLineBreak, html)
+      );
+      html.clear();
+      blockBegin = current;
+
+      while (unchangedBlock < this->blocks.size() &&
+             this->getNewOffset(this->blocks[unchangedBlock], size) < current)
+      {
+        ++unchangedBlock;
+      }
+
+      if (unchangedBlock < this->blocks.size() &&
+          this->getNewOffset(this->blocks[unchangedBlock], size) == current)
+      {
+        return unchangedBlock;
+      }
+    }
+
+    session->Finish();
+
+    if (blockBegin < size)
+    {
+      result.push_back(makeBlock(markdown, blockBegin, size, false, html));
+    }
+
+    return this->blocks.size();
+  }
+
+  static Block makeBlock(
+    const char* markdown,
+    size_t begin,
+    size_t end,
+    bool isClosed,
+    const std::string& html
+  )
+  {
+    Block block;
+    block.sourceOffset = begin;
+    block.sourceSize = end - begin;
+    block.hash = ContentHash::Compute(markdown + begin, end - begin);
+    block.isClosed = isClosed;
+    block.html = html;
+
+    return block;
+  }
+}; // class IncrementalParser
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
@@ -6,9 +6,9 @@
 
 // -----------------------------------------------------------------------------
 
-#include <regex>
 #include <string>
 
+#include "maddy/inlineparser.h"
 #include "maddy/lineparser.h"
 
 // -----------------------------------------------------------------------------
@@ -32,16 +32,16 @@ public:
    *
    * To HTML: `text <code>some code</code>`
    *
+   * `&`, `<` and `>` in the code are escaped.
+   *
    * @method
    * @param {std::string&} line The line to interpret
    * @return {void}
    */
   void Parse(std::string& line) override
   {
-    static std::regex re("`([^`]*)`");
-    static std::string replacement = "<code>$1</code>";
-
-    line = std::regex_replace(line, re, replacement);
+    InlineParser::EscapeInlineCode(line);
+    InlineParser::ParseInlineCode(line);
   }
 }; // class InlineCodeParser
 
@@ -0,0 +1,764 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "maddy/bytescanner.h"
+#include "maddy/htmlescape.h"
+#include "maddy/parserconfig.h"
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * InlineParser
+ *
+ * Hand-written replacement for the `std::regex` based line parsers. It
+ * produces exactly the same output as running `ImageParser`, `LinkParser`,
+ * `StrongParser`, `EmphasizedParser`, `StrikeThroughParser`,
+ * `InlineCodeParser`, `ItalicParser` and `BreakLineParser` in this order.
+ *
+ * The line is scanned once for the bytes which can start inline markup (with
+ * SIMD, see `ByteScanner`), and only the steps whose markup can occur are run
+ * at all. Every step is a linear left-to-right scan without recursion, so
+ * also very long lines are handled in linear time and bounded stack. A line
+ * without any markup is neither copied nor modified.
+ *
+ * The steps stay separate, because later steps have to see the output of the
+ * earlier ones, e.g. `_` inside a link target of a `LinkParser` result is
+ * still turned into `<em>` by the `EmphasizedParser`.
+ *
+ * `&`, `<` and `>` inside inline code are escaped before all steps, while the
+ * code is still the text of the Markdown (see `EscapeInlineCode`).
+ *
+ * @class
+ */
+class InlineParser
+{
+public:
+  /**
+   * Parse
+   *
+   * Runs all inline steps enabled in `features`.
+   *
+   * @method
+   * @param {std::string&} line The line to interpret
+   * @param {const Features&} features
+   * @return {void}
+   */
+  template <class Features>
+  static void Parse(std::string& line, const Features& features)
+  {
+    const uint32_t triggers = scanTriggers(line);
+
+    if (triggers == 0)
+    {
+      return;
+    }
+
+    if (features.IsEnabled(maddy::types::INLINE_CODE_PARSER) &&
+        (triggers & BACKTICK_TRIGGER) != 0)
+    {
+      EscapeInlineCode(line);
+    }
+
+    // Attention! images have to be before links
+    if (features.IsEnabled(maddy::types::IMAGE_PARSER) &&
+        (triggers & IMAGE_TRIGGER) == IMAGE_TRIGGER)
+    {
+      ParseImages(line);
+    }
+
+    if (features.IsEnabled(maddy::types::LINK_PARSER) &&
+        (triggers & BRACKET_TRIGGER) != 0)
+    {
+      ParseLinks(line);
+    }
+
+    // Attention! strong has to be before emphasized
+    if (features.IsEnabled(maddy::types::STRONG_PARSER) &&
+        (triggers & (ASTERISK_TRIGGER | UNDERSCORE_TRIGGER)) != 0)
+    {
+      ParseStrong(line);
+    }
+
+    if (features.IsEnabled(maddy::types::EMPHASIZED_PARSER) &&
+        (triggers & UNDERSCORE_TRIGGER) != 0)
+    {
+      ParseEmphasized(line);
+    }
+
+    if (features.IsEnabled(maddy::types::STRIKETHROUGH_PARSER) &&
+        (triggers & TILDE_TRIGGER) != 0)
+    {
+      ParseStrikeThrough(line);
+    }
+
+    if (features.IsEnabled(maddy::types::INLINE_CODE_PARSER) &&
+        (triggers & BACKTICK_TRIGGER) != 0)
+    {
+      ParseInlineCode(line);
+    }
+
+    if (features.IsEnabled(maddy::types::ITALIC_PARSER) &&
+        (triggers & ASTERISK_TRIGGER) != 0)
+    {
+      ParseItalic(line);
+    }
+
+    if (features.IsEnabled(maddy::types::BREAKLINE_PARSER) &&
+        (triggers & CARRIAGE_RETURN_TRIGGER) != 0)
+    {
+      ParseBreakLines(line);
+    }
+  }
+
+  /**
+   * ParseImages
+   *
+   * `![text](http://example.com/a.png)` to
+   * `<img src="http://example.com/a.png" alt="text"/>`
+   *
+   * @method
+   * @param {std::string&} line
+   * @return {void}
+   */
+  static void ParseImages(std::string& line)
+  {
+    const size_t size = line.size();
+    ForwardFinder altEndFinder(line, ']');
+    ForwardFinder srcEndFinder(line, ']');
+    std::string result;
+    size_t copied = 0;
+    size_t pos = 0;
+    // the end of a match only depends on the `]` closing the alt text
+    size_t cachedClose = std::string::npos;
+    size_t cachedEnd = std::string::npos;
+
+    while ((pos = line.find("![", pos)) != std::string::npos)
+    {
+      const size_t close = altEndFinder.Find(pos + 2);
+
+      if (close == std::string::npos)
+      {
+        break;
+      }
+
+      if (close != cachedClose)
+      {
+        cachedClose = close;
+        cachedEnd = std::string::npos;
+
+        if (close + 1 < size && line[close + 1] == '(')
+        {
+          const size_t srcBegin = close + 2;
+          size_t srcEnd = srcEndFinder.Find(srcBegin);
+
+          if (srcEnd == std::string::npos)
+          {
+            srcEnd = size;
+          }
+
+          // the source may contain `)`, the match ends at the last one
+          for (size_t i = srcEnd; i > srcBegin; --i)
+          {
+            if (line[i - 1] == ')')
+            {
+              cachedEnd = i;
+              break;
+            }
+          }
+        }
+      }
+
+      if (cachedEnd == std::string::npos)
+      {
+        ++pos;
+        continue;
+      }
+
+      result.append(line, copied, pos - copied);
+      result += "<img src=\"";
+      result.append(line, close + 2, cachedEnd - 1 - (close + 2));
+      result += "\" alt=\"";
+      result.append(line, pos + 2, close - (pos + 2));
+      result += "\"/>";
+      copied = pos = cachedEnd;
+    }
+
+    finishReplacement(line, result, copied);
+  }
+
+  /**
+   * ParseLinks
+   *
+   * `[text](http://example.com "title")` to
+   * `<a href="http://example.com" title="title">text</a>` and
+   * `[text](http://example.com)` to `<a href="http://example.com">text</a>`
+   *
+   * @method
+   * @param {std::string&} line
+   * @return {void}
+   */
+  static void ParseLinks(std::string& line)
+  {
+    parseLinks(line, true);
+    parseLinks(line, false);
+  }
+
+  /**
+   * ParseStrong
+   *
+   * `**text**` and `__text__` to `<strong>text</strong>`
+   *
+   * @method
+   * @param {std::string&} line
+   * @return {void}
+   */
+  static void ParseStrong(std::string& line)
+  {
+    parseDelimited(line, '*', 2, "<strong>", "</strong>");
+    parseDelimited(line, '_', 2, "<strong>", "</strong>");
+  }
+
+  /**
+   * ParseEmphasized
+   *
+   * `_text_` to `<em>text</em>`
+   *
+   * @method
+   * @param {std::string&} line
+   * @return {void}
+   */
+  static void ParseEmphasized(std::string& line)
+  {
+    parseDelimited(line, '_', 1, "<em>", "</em>");
+  }
+
+  /**
+   * ParseStrikeThrough
+   *
+   * `~~text~~` to `<s>text</s>`
+   *
+   * @method
+   * @param {std::string&} line
+   * @return {void}
+   */
+  static void ParseStrikeThrough(std::string& line)
+  {
+    parseDelimited(line, '~', 2, "<s>", "</s>");
+  }
+
+  /**
+   * EscapeInlineCode
+   *
+   * Escapes `&`, `<` and `>` between the backticks, which `ParseInlineCode`
+   * turns into `<code>`. It has to run before the other steps add their HTML
+   * inside the code. A line without any of these bytes is not copied.
+   *
+   * @method
+   * @param {std::string&} line
+   * @return {void}
+   */
+  static void EscapeInlineCode(std::string& line)
+  {
+    if (HtmlEscape::IsTextEscaped(line.data(), line.size()))
+    {
+      return;
+    }
+
+    std::string result;
+    size_t copied = 0;
+    size_t pos = 0;
+
+    while ((pos = line.find('`', pos)) != std::string::npos)
+    {
+      const size_t close = line.find('`', pos + 1);
+
+      if (close == std::string::npos)
+      {
+        break;
+      }
+
+      if (!HtmlEscape::IsTextEscaped(line.data() + pos, close - pos))
+      {
+        result.append(line, copied, pos - copied);
+        HtmlEscape::AppendText(result, line.data() + pos, close - pos);
+        copied = close;
+      }
+
+      pos = close + 1;
+    }
+
+    finishReplacement(line, result, copied);
+  }
+
+  /**
+   * ParseInlineCode
+   *
+   * `` `some code` `` to `<code>some code</code>`
+   *
+   * @method
+   * @param {std::string&} line
+   * @return {void}
+   */
+  static void ParseInlineCode(std::string& line)
+  {
+    std::string result;
+    size_t copied = 0;
+    size_t pos = 0;
+
+    while ((pos = line.find('`', pos)) != std::string::npos)
+    {
+      const size_t close = line.find('`', pos + 1);
+
+      if (close == std::string::npos)
+      {
+        break;
+      }
+
+      result.append(line, copied, pos - copied);
+      result += "<code>";
+      result.append(line, pos + 1, close - pos - 1);
+      result += "</code>";
+      copied = pos = close + 1;
+    }
+
+    finishReplacement(line, result, copied);
+  }
+
+  /**
+   * ParseItalic
+   *
+   * `*text*` to `<i>text</i>`
+   *
+   * @method
+   * @param {std::string&} line
+   * @return {void}
+   */
+  static void ParseItalic(std::string& line)
+  {
+    parseDelimited(line, '*', 1, "<i>", "</i>");
+  }
+
+  /**
+   * ParseBreakLines
+   *
+   * `\r\n` and `\r` to `<br>`
+   *
+   * @method
+   * @param {std::string&} line
+   * @return {void}
+   */
+  static void ParseBreakLines(std::string& line)
+  {
+    std::string result;
+    size_t copied = 0;
+    size_t pos = 0;
+
+    while ((pos = line.find('\r', pos)) != std::string::npos)
+    {
+      result.append(line, copied, pos - copied);
+      result += "<br>";
+      pos += (pos + 1 < line.size() && line[pos + 1] == '\n') ? 2 : 1;
+      copied = pos;
+    }
+
+    finishReplacement(line, result, copied);
+  }
+
+private:
+  // bytes, which can start inline markup, see `scanTriggers`
+  enum TRIGGER : uint32_t
+  {
+    EXCLAMATION_TRIGGER = 0b1,
+    BRACKET_TRIGGER = 0b10,
+    ASTERISK_TRIGGER = 0b100,
+    UNDERSCORE_TRIGGER = 0b1000,
+    TILDE_TRIGGER = 0b10000,
+    BACKTICK_TRIGGER = 0b100000,
+    CARRIAGE_RETURN_TRIGGER = 0b1000000,
+
+    IMAGE_TRIGGER = EXCLAMATION_TRIGGER | BRACKET_TRIGGER,
+  };
+
+  /**
+   * CodeGuard
+   *
+   * The strong, emphasized, strike-through and italic regular expressions
+   * were guarded by lookaheads like `(?!.*`.*|.*<code>.*)`: they must not
+   * match at a position, after which a backtick or `<code>` follows in the
+   * same line. As `.` does not match `\r` and `\n`, "the same line" ends at
+   * the next `\r` or `\n`.
+   *
+   * The guard remembers the last backtick, `<code>` and `</code>` of every
+   * such segment, so each check is a comparison.
+   */
+  class CodeGuard
+  {
+  public:
+    explicit CodeGuard(const std::string& line)
+      : isActive(
+          line.find('`') != std::string::npos ||
+          line.find('<') != std::string::npos
+        )
+    {
+      if (!this->isActive)
+      {
+        return;
+      }
+
+      Segment segment = {0, 0, 0, 0};
+
+      for (size_t i = 0; i < line.size(); ++i)
+      {
+        const char c = line[i];
+
+        if (c == '\r' || c == '\n')
+        {
+          segment.end = i;
+          this->segments.push_back(segment);
+          segment = Segment{0, 0, 0, 0};
+        }
+        else if (c == '`')
+        {
+          segment.lastBacktick = i + 1;
+        }
+        else if (c == '<')
+        {
+          if (line.compare(i, 6, "<code>") == 0)
+          {
+            segment.lastCodeOpen = i + 1;
+          }
+          else if (line.compare(i, 7, "</code>") == 0)
+          {
+            segment.lastCodeClose = i + 1;
+          }
+        }
+      }
+
+      segment.end = line.size();
+      this->segments.push_back(segment);
+    }
+
+    // `(?!.*`.*|.*<code>.*)`
+    bool AllowsOpening(size_t pos) const
+    {
+      if (!this->isActive)
+      {
+        return true;
+      }
+
+      const Segment& segment = this->getSegment(pos);
+      return segment.lastBacktick <= pos && segment.lastCodeOpen <= pos;
+    }
+
+    // `(?!.*`.*|.*<\/code>.*)`
+    bool AllowsContent(size_t pos) const
+    {
+      if (!this->isActive)
+      {
+        return true;
+      }
+
+      const Segment& segment = this->getSegment(pos);
+      return segment.lastBacktick <= pos && segment.lastCodeClose <= pos;
+    }
+
+  private:
+    // positions are stored + 1, so that 0 means "not found"
+    struct Segment
+    {
+      size_t end;
+      size_t lastBacktick;
+      size_t lastCodeOpen;
+      size_t lastCodeClose;
+    };
+
+    bool isActive;
+    std::vector<Segment> segments;
+
+    const Segment& getSegment(size_t pos) const
+    {
+      if (this->segments.size() == 1)
+      {
+        return this->segments[0];
+      }
+
+      return *std::lower_bound(
+        this->segments.begin(),
+        this->segments.end(),
+        pos,
+        [](const Segment& segment, size_t position)
+        { return segment.end < position; }
+      );
+    }
+  }; // class CodeGuard
+
+  /**
+   * ForwardFinder
+   *
+   * `std::string::find` for one character, which remembers its last result.
+   * Repeated searches from positions before that result do not scan the same
+   * bytes again, which keeps the steps linear for inputs like `![![![![...`.
+   */
+  class ForwardFinder
+  {
+  public:
+    ForwardFinder(const std::string& line, char character)
+      : line(line)
+      , character(character)
+      , from(std::string::npos)
+      , found(0)
+    {}
+
+    size_t Find(size_t pos)
+    {
+      if (pos < this->from || pos > this->found)
+      {
+        this->from = pos;
+        this->found = this->line.find(this->character, pos);
+      }
+
+      return this->found;
+    }
+
+  private:
+    const std::string& line;
+    char character;
+    size_t from;
+    size_t found;
+  }; // class ForwardFinder
+
+  static uint32_t scanTriggers(const std::string& line)
+  {
+    // in the order of the `TRIGGER` bits
+    static const ByteScanner scanner("![*_~`\r");
+
+    return scanner.Collect(line.data(), line.data() + line.size());
+  }
+
+  static void finishReplacement(
+    std::string& line, std::string& result, size_t copied
+  )
+  {
+    if (copied == 0)
+    {
+      return;
+    }
+
+    result.append(line, copied, std::string::npos);
+    line.swap(result);
+  }
+
+  /**
+   * parseDelimited
+   *
+   * Replaces `<delimiter>text<delimiter>`, where `text` does not contain the
+   * delimiter character and the delimiter is `length` times the character.
+   */
+  static void parseDelimited(
+    std::string& line,
+    char delimiter,
+    size_t length,
+    const char* openingTag,
+    const char* closingTag
+  )
+  {
+    const size_t size = line.size();
+
+    if (line.find(delimiter) == std::string::npos)
+    {
+      return;
+    }
+
+    const CodeGuard guard(line);
+    std::string result;
+    size_t copied = 0;
+    size_t pos = 0;
+
+    while ((pos = line.find(delimiter, pos)) != std::string::npos)
+    {
+      if (pos + length > size ||
+          (length == 2 && line[pos + 1] != delimiter))
+      {
+        ++pos;
+        continue;
+      }
+
+      const size_t contentBegin = pos + length;
+
+      if (!guard.AllowsOpening(pos) || !guard.AllowsContent(contentBegin))
+      {
+        ++pos;
+        continue;
+      }
+
+      const size_t close = line.find(delimiter, contentBegin);
+
+      if (close == std::string::npos || close + length > size ||
+          (length == 2 && line[close + 1] != delimiter) ||
+          !guard.AllowsContent(close + length))
+      {
+        ++pos;
+        continue;
+      }
+
+      result.append(line, copied, pos - copied);
+      result += openingTag;
+      result.append(line, contentBegin, close - contentBegin);
+      result += closingTag;
+      copied = pos = close + length;
+    }
+
+    finishReplacement(line, result, copied);
+  }
+
+  static bool isLinkTargetCharacter(char c)
+  {
+    return c != ')' && c != '^' && c != ' ' && c != '"';
+  }
+
+  static size_t skipSpaces(const std::string& line, size_t pos)
+  {
+    while (pos < line.size() && line[pos] == ' ')
+    {
+      ++pos;
+    }
+
+    return pos;
+  }
+
+  /**
+   * parseLinks
+   *
+   * `\[([^\]]*)\]\( *([^)^ ^"]*) *\"([^\"]*)\" *\)` with title and
+   * `\[([^\]]*)\]\( *([^)^ ^"]*) *\)` without.
+   */
+  static void parseLinks(std::string& line, bool withTitle)
+  {
+    const size_t size = line.size();
+    ForwardFinder textEndFinder(line, ']');
+    ForwardFinder titleEndFinder(line, '"');
+    std::string result;
+    size_t copied = 0;
+    size_t pos = 0;
+    // everything after the `]` only depends on its position
+    size_t cachedClose = std::string::npos;
+    size_t targetBegin = 0;
+    size_t targetEnd = std::string::npos;
+    // everything after the link target only depends on where it ends
+    size_t cachedTargetEnd = std::string::npos;
+    size_t cachedEnd = std::string::npos;
+    size_t titleBegin = 0;
+    size_t titleEnd = 0;
+
+    while ((pos = line.find('[', pos)) != std::string::npos)
+    {
+      const size_t close = textEndFinder.Find(pos + 1);
+
+      if (close == std::string::npos)
+      {
+        break;
+      }
+
+      if (close != cachedClose)
+      {
+        cachedClose = close;
+        targetEnd = std::string::npos;
+
+        if (close + 1 < size && line[close + 1] == '(')
+        {
+          targetBegin = skipSpaces(line, close + 2);
+
+          // all `(` of `[a](b](c)` start in the same run of target characters
+          if (cachedTargetEnd == std::string::npos ||
+              targetBegin > cachedTargetEnd)
+          {
+            size_t end = targetBegin;
+
+            while (end < size && isLinkTargetCharacter(line[end]))
+            {
+              ++end;
+            }
+
+            targetEnd = end;
+          }
+          else
+          {
+            targetEnd = cachedTargetEnd;
+          }
+        }
+      }
+
+      if (targetEnd != std::string::npos && targetEnd != cachedTargetEnd)
+      {
+        cachedTargetEnd = targetEnd;
+        cachedEnd = std::string::npos;
+        size_t next = skipSpaces(line, targetEnd);
+
+        if (withTitle)
+        {
+          if (next < size && line[next] == '"')
+          {
+            titleBegin = next + 1;
+            titleEnd = titleEndFinder.Find(titleBegin);
+
+            if (titleEnd != std::string::npos)
+            {
+              next = skipSpaces(line, titleEnd + 1);
+
+              if (next < size && line[next] == ')')
+              {
+                cachedEnd = next + 1;
+              }
+            }
+          }
+        }
+        else if (next < size && line[next] == ')')
+        {
+          cachedEnd = next + 1;
+        }
+      }
+
+      if (targetEnd == std::string::npos || cachedEnd == std::string::npos)
+      {
+        ++pos;
+        continue;
+      }
+
+      result.append(line, copied, pos - copied);
+      result += "<a href=\"";
+      result.append(line, targetBegin, targetEnd - targetBegin);
+
+      if (withTitle)
+      {
+        result += "\" title=\"";
+        result.append(line, titleBegin, titleEnd - titleBegin);
+      }
+
+      result += "\">";
+      result.append(line, pos + 1, close - pos - 1);
+      result += "</a>";
+      copied = pos = cachedEnd;
+    }
+
+    finishReplacement(line, result, copied);
+  }
+}; // class InlineParser
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
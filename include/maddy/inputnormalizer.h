@@ -0,0 +1,311 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+#include "maddy/simd.h"
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * InputNormalizer
+ *
+ * Prepares the content of a file for the parser in one pass over the buffer:
+ *
+ * - a UTF-8 byte order mark at the start is removed
+ * - `\r\n` and single `\r` become `\n`, so no `\r` is left at the end of the
+ *   lines (the parser would turn it into `<br>` and it hides block starts
+ *   like `# headline\r`)
+ * - the text is validated as UTF-8, overlong forms, surrogates and code
+ *   points above U+10FFFF are invalid
+ *
+ * The buffer is changed in place without any allocation. With SSE2, blocks of
+ * 16 ASCII bytes are validated and moved at once and the runs between line
+ * breaks are copied as a whole. Only blocks with non-ASCII characters are
+ * validated byte by byte.
+ *
+ * ```
+ * maddy::InputNormalizer::Result input =
+ *   maddy::InputNormalizer::Normalize(markdown);
+ * if (!input.hasByteOrderMark && !input.isValidUtf8)
+ * {
+ *   // convert from the local code page
+ * }
+ * ```
+ *
+ * @class
+ */
+class InputNormalizer
+{
+public:
+  /**
+   * Result
+   *
+   * `size` is the size of the normalized text. Line breaks are normalized
+   * also if the text is not valid UTF-8.
+   */
+  struct Result
+  {
+    size_t size;
+    bool hasByteOrderMark;
+    bool isValidUtf8;
+  };
+
+  /**
+   * Normalize
+   *
+   * @method
+   * @param {char*} data is normalized in place
+   * @param {size_t} size
+   * @return {Result}
+   */
+  static Result Normalize(char* data, size_t size)
+  {
+    Result result = {0, false, true};
+    Utf8Validator validator;
+    size_t read = 0;
+    size_t write = 0;
+
+    if (size >= 3 && static_cast<unsigned char>(data[0]) == 0xEF &&
+        static_cast<unsigned char>(data[1]) == 0xBB &&
+        static_cast<unsigned char>(data[2]) == 0xBF)
+    {
+      result.hasByteOrderMark = true;
+      read = 3;
+    }
+
+#if defined(MADDY_SIMD_SSE2)
+    const __m128i carriageReturns = _mm_set1_epi8('\r');
+
+    while (size - read >= 16)
+    {
+      const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + read));
+      // after invalid UTF-8 only the line breaks are of interest
+      const uint32_t nonAsciiMask = validator.isValid
+        ? static_cast<uint32_t>(_mm_movemask_epi8(chunk))
+        : 0;
+      const uint32_t carriageReturnMask = static_cast<uint32_t>(
+        _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, carriageReturns))
+      );
+
+      if (nonAsciiMask != 0 || validator.pending != 0)
+      {
+        for (const size_t chunkEnd = read + 16; read < chunkEnd;)
+        {
+          addByte(data, size, read, write, validator);
+        }
+
+        continue;
+      }
+
+      if (carriageReturnMask == 0)
+      {
+        if (write != read)
+        {
+          // only overwrites bytes of this chunk, which were already loaded
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(data + write), chunk);
+        }
+
+        read += 16;
+        write += 16;
+        continue;
+      }
+
+      const size_t chunkEnd = read + 16;
+      uint32_t mask = carriageReturnMask;
+
+      while (mask != 0)
+      {
+        const size_t carriageReturn =
+          chunkEnd - 16 + simd::CountTrailingZeros(mask);
+        mask &= mask - 1;
+
+        move(data, read, write, carriageReturn - read);
+        addCarriageReturn(data, size, read, write);
+      }
+
+      move(data, read, write, chunkEnd - read);
+    }
+#endif
+
+    while (read < size)
+    {
+      addByte(data, size, read, write, validator);
+    }
+
+    result.size = write;
+    result.isValidUtf8 = validator.isValid && validator.pending == 0;
+
+    return result;
+  }
+
+  /**
+   * Normalize
+   *
+   * @method
+   * @param {std::string&} text is normalized in place
+   * @return {Result}
+   */
+  static Result Normalize(std::string& text)
+  {
+    if (text.empty())
+    {
+      Result result = {0, false, true};
+      return result;
+    }
+
+    const Result result = Normalize(&text[0], text.size());
+    text.resize(result.size);
+
+    return result;
+  }
+
+private:
+  /**
+   * Utf8Validator
+   *
+   * State machine of the well-formed UTF-8 byte sequences (Unicode, table
+   * 3-7): the first continuation byte has a smaller range after some lead
+   * bytes.
+   */
+  struct Utf8Validator
+  {
+    Utf8Validator()
+      : pending(0)
+      , lower(0x80)
+      , upper(0xBF)
+      , isValid(true)
+    {}
+
+    void Add(unsigned char c)
+    {
+      if (this->pending != 0)
+      {
+        if (c < this->lower || c > this->upper)
+        {
+          this->isValid = false;
+          this->pending = 0;
+          return;
+        }
+
+        --this->pending;
+        this->lower = 0x80;
+        this->upper = 0xBF;
+        return;
+      }
+
+      if (c < 0x80)
+      {
+        return;
+      }
+
+      if (c >= 0xC2 && c <= 0xDF)
+      {
+        this->pending = 1;
+      }
+      else if (c == 0xE0)
+      {
+        this->pending = 2;
+        this->lower = 0xA0;
+      }
+      else if (c == 0xED)
+      {
+        this->pending = 2;
+        this->upper = 0x9F;
+      }
+      else if (c >= 0xE1 && c <= 0xEF)
+      {
+        this->pending = 2;
+      }
+      else if (c == 0xF0)
+      {
+        this->pending = 3;
+        this->lower = 0x90;
+      }
+      else if (c == 0xF4)
+      {
+        this->pending = 3;
+        this->upper = 0x8F;
+      }
+      else if (c >= 0xF1 && c <= 0xF3)
+      {
+        this->pending = 3;
+      }
+      else
+      {
+        this->isValid = false;
+      }
+    }
+
+    uint8_t pending;
+    unsigned char lower;
+    unsigned char upper;
+    bool isValid;
+  }; // struct Utf8Validator
+
+  static void move(char* data, size_t& read, size_t& write, size_t size)
+  {
+    if (write != read)
+    {
+      std::memmove(data + write, data + read, size);
+    }
+
+    read += size;
+    write += size;
+  }
+
+  static void addCarriageReturn(
+    char* data, size_t size, size_t& read, size_t& write
+  )
+  {
+    // `\r\n`: the `\n` is taken with the next byte
+    if (read + 1 >= size || data[read + 1] != '\n')
+    {
+      data[write++] = '\n';
+    }
+
+    ++read;
+  }
+
+  static void addByte(
+    char* data,
+    size_t size,
+    size_t& read,
+    size_t& write,
+    Utf8Validator& validator
+  )
+  {
+    const char c = data[read];
+
+    if (validator.isValid)
+    {
+      validator.Add(static_cast<unsigned char>(c));
+    }
+
+    if (c == '\r')
+    {
+      addCarriageReturn(data, size, read, write);
+      return;
+    }
+
+    data[write++] = c;
+    ++read;
+  }
+}; // class InputNormalizer
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
@@ -6,9 +6,9 @@
 
 // -----------------------------------------------------------------------------
 
-#include <regex>
 #include <string>
 
+#include "maddy/inlineparser.h"
 #include "maddy/lineparser.h"
 
 // -----------------------------------------------------------------------------
@@ -38,11 +38,7 @@ public:
    */
   void Parse(std::string& line) override
   {
-    static std::regex re(
-      R"((?!.*`.*|.*<code>.*)\*(?!.*`.*|.*<\/code>.*)([^\*]*)\*(?!.*`.*|.*<\/code>.*))"
-    );
-    static std::string replacement = "<i>$1</i>";
-    line = std::regex_replace(line, re, replacement);
+    InlineParser::ParseItalic(line);
   }
 }; // class ItalicParser
 
@@ -7,7 +7,6 @@
 // -----------------------------------------------------------------------------
 
 #include <functional>
-#include <regex>
 #include <string>
 
 #include "maddy/blockparser.h"
@@ -51,12 +50,12 @@ public:
    *
    * @method
    * @param {std::function<void(std::string&)>} parseLineCallback
-   * @param {std::function<std::shared_ptr<BlockParser>(const std::string&
-   * line)>} getBlockParserForLineCallback
+   * @param {std::function<BlockParser*(const std::string& line)>}
+   * getBlockParserForLineCallback
    */
   LatexBlockParser(
     std::function<void(std::string&)> parseLineCallback,
-    std::function<std::shared_ptr<BlockParser>(const std::string& line)>
+    std::function<BlockParser*(const std::string& line)>
       getBlockParserForLineCallback
   )
     : BlockParser(parseLineCallback, getBlockParserForLineCallback)
@@ -79,8 +78,7 @@ public:
    */
   static bool IsStartingLine(const std::string& line)
   {
-    static std::regex re(R"(^(?:\$){2}(.*)$)");
-    return std::regex_match(line, re);
+    return line.compare(0, 2, "$$") == 0 && hasNoLineBreakFrom(line, 2);
   }
 
   /**
@@ -91,6 +89,65 @@ public:
    */
   bool IsFinished() const override { return this->isFinished; }
 
+  /**
+   * IsTakingVerbatimLines
+   *
+   * @method
+   * @return {bool}
+   */
+  bool IsTakingVerbatimLines() const override
+  {
+    return this->isStarted && !this->isFinished;
+  }
+
+  /**
+   * AddVerbatimLines
+   *
+   * Copies the lines up to the one ending with `$$` at once.
+   *
+   * @method
+   * @param {const char*} begin
+   * @param {const char*} end
+   * @param {size_t} maxLineLength
+   * @return {const char*}
+   */
+  const char* AddVerbatimLines(
+    const char* begin, const char* end, size_t maxLineLength
+  ) override
+  {
+    const char* current = begin;
+
+    while (current < end)
+    {
+      const char* lineEnd = findVerbatimLineEnd(current, end, maxLineLength);
+
+      if (!lineEnd ||
+          (lineEnd - current > 1 && lineEnd[-2] == '$' && lineEnd[-1] == '$'))
+      {
+        break;
+      }
+
+      current = lineEnd + 1;
+    }
+
+    this->result.Append(begin, static_cast<size_t>(current - begin));
+
+    return current;
+  }
+
+  /**
+   * Reset
+   *
+   * @method
+   * @return {void}
+   */
+  void Reset() override
+  {
+    BlockParser::Reset();
+    this->isStarted = false;
+    this->isFinished = false;
+  }
+
 protected:
   bool isInlineBlockAllowed() const override { return false; }
 
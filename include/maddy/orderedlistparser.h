@@ -7,10 +7,9 @@
 // -----------------------------------------------------------------------------
 
 #include <functional>
-#include <regex>
 #include <string>
 
-#include "maddy/blockparser.h"
+#include "maddy/containerparser.h"
 
 // -----------------------------------------------------------------------------
 
@@ -23,7 +22,7 @@ namespace maddy {
  *
  * @class
  */
-class OrderedListParser : public BlockParser
+class OrderedListParser : public ContainerParser
 {
 public:
   /**
@@ -31,15 +30,15 @@ public:
    *
    * @method
    * @param {std::function<void(std::string&)>} parseLineCallback
-   * @param {std::function<std::shared_ptr<BlockParser>(const std::string&
-   * line)>} getBlockParserForLineCallback
+   * @param {std::function<BlockParser*(const std::string& line)>}
+   * getBlockParserForLineCallback
    */
   OrderedListParser(
     std::function<void(std::string&)> parseLineCallback,
-    std::function<std::shared_ptr<BlockParser>(const std::string& line)>
+    std::function<BlockParser*(const std::string& line)>
       getBlockParserForLineCallback
   )
-    : BlockParser(parseLineCallback, getBlockParserForLineCallback)
+    : ContainerParser(parseLineCallback, getBlockParserForLineCallback)
     , isStarted(false)
     , isFinished(false)
   {}
@@ -55,8 +54,7 @@ public:
    */
   static bool IsStartingLine(const std::string& line)
   {
-    static std::regex re("^1\\. .*");
-    return std::regex_match(line, re);
+    return line.compare(0, 3, "1. ") == 0 && hasNoLineBreakFrom(line, 3);
   }
 
   /**
@@ -67,58 +65,73 @@ public:
    */
   bool IsFinished() const override { return this->isFinished; }
 
-protected:
-  bool isInlineBlockAllowed() const override { return true; }
+  /**
+   * Reset
+   *
+   * @method
+   * @return {void}
+   */
+  void Reset() override
+  {
+    ContainerParser::Reset();
+    this->isStarted = false;
+    this->isFinished = false;
+  }
 
-  bool isLineParserAllowed() const override { return true; }
+protected:
+  size_t getChildIndentation() const override { return 2; }
 
-  void parseBlock(std::string& line) override
+  void parseContainerLine(ContainerLine& line) override
   {
-    bool isStartOfNewListItem = this->isStartOfNewListItem(line);
-    uint32_t indentation = getIndentationWidth(line);
+    // `^[1-9]+[0-9]*\. `
+    const size_t numberEnd =
+      line.At(0) >= '1' && line.At(0) <= '9' ? line.CountDigits() : 0;
+    const bool isNumbered = numberEnd > 0 && line.At(numberEnd) == '.' &&
+                            line.At(numberEnd + 1) == ' ';
+    const bool isStartOfNewListItem =
+      line.StartsWith("* ")
+        ? line.HasNoLineBreakFrom(2)
+        : isNumbered && line.HasNoLineBreakFrom(numberEnd + 2);
+    const bool isNested = line.IsIndented(2);
+
+    if (isNumbered)
+    {
+      line.Erase(numberEnd + 2);
+    }
 
-    static std::regex orderedlineRegex(R"(^[1-9]+[0-9]*\. )");
-    line = std::regex_replace(line, orderedlineRegex, "");
-    static std::regex unorderedlineRegex(R"(^\* )");
-    line = std::regex_replace(line, unorderedlineRegex, "");
+    line.ErasePrefix("* ");
 
     if (!this->isStarted)
     {
-      line = "<ol><li>" + line;
+      line.Insert("<ol><li>");
       this->isStarted = true;
       return;
     }
 
-    if (indentation >= 2)
+    if (isNested)
     {
-      line = line.substr(2);
+      line.Erase(2);
       return;
     }
 
-    if (line.empty() || line.find("</li><li>") != std::string::npos ||
-        line.find("</li></ol>") != std::string::npos ||
-        line.find("</li></ul>") != std::string::npos)
+    // the closing tags of a parent item close this list as well
+    if (line.IsEmpty() || line.IsItemClosed() ||
+        line.ContainsTag("</li>", {"<li>", "</ol>", "</ul>"}))
     {
-      line = "</li></ol>" + line;
+      line.CloseItem("</li></ol>");
       this->isFinished = true;
       return;
     }
 
     if (isStartOfNewListItem)
     {
-      line = "</li><li>" + line;
+      line.CloseItem("</li><li>");
     }
   }
 
 private:
   bool isStarted;
   bool isFinished;
-
-  bool isStartOfNewListItem(const std::string& line) const
-  {
-    static std::regex re(R"(^(?:[1-9]+[0-9]*\. |\* ).*)");
-    return std::regex_match(line, re);
-  }
 }; // class OrderedListParser
 
 // -----------------------------------------------------------------------------
@@ -0,0 +1,183 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <cstddef>
+#include <string>
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * OutputBuffer
+ *
+ * Append-only buffer for the HTML of a block parser.
+ *
+ * A buffer can be shared with the buffer of another parser, then everything
+ * is appended to that one. Child parsers share the buffer of their parent,
+ * so the HTML of nested lists and quotes is written once into the buffer of
+ * the top-level block instead of being copied up level by level.
+ *
+ * `str()` and `operator<<` are kept from the `std::stringstream`, which was
+ * used before.
+ *
+ * @class
+ */
+class OutputBuffer
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   */
+  OutputBuffer() : target(nullptr) {}
+
+  /**
+   * Append
+   *
+   * @method
+   * @param {const char*} data
+   * @param {size_t} size
+   * @return {void}
+   */
+  void Append(const char* data, size_t size)
+  {
+    this->get().buffer.append(data, size);
+  }
+
+  /**
+   * Append
+   *
+   * @method
+   * @param {const std::string&} text
+   * @return {void}
+   */
+  void Append(const std::string& text) { this->get().buffer += text; }
+
+  /**
+   * operator<<
+   *
+   * @method
+   * @param {const std::string&} text
+   * @return {OutputBuffer&}
+   */
+  OutputBuffer& operator<<(const std::string& text)
+  {
+    this->get().buffer += text;
+    return *this;
+  }
+
+  /**
+   * operator<<
+   *
+   * @method
+   * @param {const char*} text
+   * @return {OutputBuffer&}
+   */
+  OutputBuffer& operator<<(const char* text)
+  {
+    this->get().buffer += text;
+    return *this;
+  }
+
+  /**
+   * ShareWith
+   *
+   * From now on everything is appended to `other` (or to the buffer `other`
+   * is shared with).
+   *
+   * @method
+   * @param {OutputBuffer&} other
+   * @return {void}
+   */
+  void ShareWith(OutputBuffer& other) { this->target = &other.get(); }
+
+  /**
+   * IsShared
+   *
+   * @method
+   * @return {bool}
+   */
+  bool IsShared() const { return this->target != nullptr; }
+
+  /**
+   * GetData
+   *
+   * @method
+   * @return {const char*}
+   */
+  const char* GetData() const { return this->get().buffer.data(); }
+
+  /**
+   * GetSize
+   *
+   * @method
+   * @return {size_t}
+   */
+  size_t GetSize() const { return this->get().buffer.size(); }
+
+  /**
+   * str
+   *
+   * @method
+   * @return {std::string} a copy of the content
+   */
+  std::string str() const { return this->get().buffer; }
+
+  /**
+   * Truncate
+   *
+   * Drops everything behind `size`.
+   *
+   * @method
+   * @param {size_t} size
+   * @return {void}
+   */
+  void Truncate(size_t size)
+  {
+    OutputBuffer& buffer = this->get();
+
+    if (size < buffer.buffer.size())
+    {
+      buffer.buffer.resize(size);
+    }
+  }
+
+  /**
+   * Clear
+   *
+   * Stops sharing and removes the own content. The memory is kept for the
+   * next block.
+   *
+   * @method
+   * @return {void}
+   */
+  void Clear()
+  {
+    this->target = nullptr;
+    this->buffer.clear();
+  }
+
+private:
+  std::string buffer;
+  OutputBuffer* target;
+
+  OutputBuffer& get() { return this->target ? *this->target : *this; }
+
+  const OutputBuffer& get() const
+  {
+    return this->target ? *this->target : *this;
+  }
+}; // class OutputBuffer
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
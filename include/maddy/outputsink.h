@@ -0,0 +1,181 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <cstdio>
+#include <functional>
+#include <ostream>
+#include <string>
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * OutputSink
+ *
+ * Destination for the generated HTML. The `Parser` writes every finished
+ * block into the sink as soon as it is done, so the HTML never has to be
+ * collected in one intermediate string.
+ *
+ * @class
+ */
+class OutputSink
+{
+public:
+  /**
+   * dtor
+   *
+   * @method
+   */
+  virtual ~OutputSink() {}
+
+  /**
+   * Write
+   *
+   * @method
+   * @param {const char*} data
+   * @param {size_t} size
+   * @return {void}
+   */
+  virtual void Write(const char* data, size_t size) = 0;
+}; // class OutputSink
+
+// -----------------------------------------------------------------------------
+
+/**
+ * StringOutputSink
+ *
+ * Appends the HTML to an existing string, e.g. behind an already written
+ * HTML head.
+ *
+ * @class
+ */
+class StringOutputSink : public OutputSink
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   * @param {std::string&} output
+   */
+  explicit StringOutputSink(std::string& output) : output(output) {}
+
+  void Write(const char* data, size_t size) override
+  {
+    this->output.append(data, size);
+  }
+
+private:
+  std::string& output;
+}; // class StringOutputSink
+
+// -----------------------------------------------------------------------------
+
+/**
+ * CallbackOutputSink
+ *
+ * Hands every HTML chunk to a callback.
+ *
+ * @class
+ */
+class CallbackOutputSink : public OutputSink
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   * @param {std::function<void(const char*, size_t)>} callback
+   */
+  explicit CallbackOutputSink(
+    std::function<void(const char*, size_t)> callback
+  )
+    : callback(callback)
+  {}
+
+  void Write(const char* data, size_t size) override
+  {
+    if (this->callback)
+    {
+      this->callback(data, size);
+    }
+  }
+
+private:
+  std::function<void(const char*, size_t)> callback;
+}; // class CallbackOutputSink
+
+// -----------------------------------------------------------------------------
+
+/**
+ * StreamOutputSink
+ *
+ * Writes the HTML into a `std::ostream`.
+ *
+ * @class
+ */
+class StreamOutputSink : public OutputSink
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   * @param {std::ostream&} output
+   */
+  explicit StreamOutputSink(std::ostream& output) : output(output) {}
+
+  void Write(const char* data, size_t size) override
+  {
+    this->output.write(data, static_cast<std::streamsize>(size));
+  }
+
+private:
+  std::ostream& output;
+}; // class StreamOutputSink
+
+// -----------------------------------------------------------------------------
+
+/**
+ * FileOutputSink
+ *
+ * Writes the HTML into an open `FILE*`. A plain file descriptor can be
+ * wrapped with `fdopen` (`_fdopen` on Windows). The file is not closed by
+ * the sink.
+ *
+ * @class
+ */
+class FileOutputSink : public OutputSink
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   * @param {std::FILE*} file
+   */
+  explicit FileOutputSink(std::FILE* file) : file(file) {}
+
+  void Write(const char* data, size_t size) override
+  {
+    if (this->file && size > 0)
+    {
+      std::fwrite(data, 1, size, this->file);
+    }
+  }
+
+private:
+  std::FILE* file;
+}; // class FileOutputSink
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
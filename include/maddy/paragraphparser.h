@@ -30,12 +30,12 @@ public:
    *
    * @method
    * @param {std::function<void(std::string&)>} parseLineCallback
-   * @param {std::function<std::shared_ptr<BlockParser>(const std::string&
-   * line)>} getBlockParserForLineCallback
+   * @param {std::function<BlockParser*(const std::string& line)>}
+   * getBlockParserForLineCallback
    */
   ParagraphParser(
     std::function<void(std::string&)> parseLineCallback,
-    std::function<std::shared_ptr<BlockParser>(const std::string& line)>
+    std::function<BlockParser*(const std::string& line)>
       getBlockParserForLineCallback,
     bool isEnabled
   )
@@ -68,6 +68,19 @@ public:
    */
   bool IsFinished() const override { return this->isFinished; }
 
+  /**
+   * Reset
+   *
+   * @method
+   * @return {void}
+   */
+  void Reset() override
+  {
+    BlockParser::Reset();
+    this->isStarted = false;
+    this->isFinished = false;
+  }
+
 protected:
   bool isInlineBlockAllowed() const override { return false; }
 
@@ -77,7 +90,8 @@ protected:
   {
     if (this->isEnabled && !this->isStarted)
     {
-      line = "<p>" + line + " ";
+      this->result << "<p>";
+      line += " ";
       this->isStarted = true;
       return;
     }
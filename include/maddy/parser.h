@@ -6,34 +6,21 @@
 
 // -----------------------------------------------------------------------------
 
-#include <functional>
+#include <algorithm>
+#include <istream>
 #include <memory>
 #include <string>
-
+#include <thread>
+
+#include "maddy/basicparser.h"
+#include "maddy/blockcache.h"
+#include "maddy/contenthash.h"
+#include "maddy/documentoutline.h"
+#include "maddy/documenttree.h"
+#include "maddy/outputsink.h"
+#include "maddy/parserbudget.h"
 #include "maddy/parserconfig.h"
-
-// BlockParser
-#include "maddy/checklistparser.h"
-#include "maddy/codeblockparser.h"
-#include "maddy/headlineparser.h"
-#include "maddy/horizontallineparser.h"
-#include "maddy/htmlparser.h"
-#include "maddy/latexblockparser.h"
-#include "maddy/orderedlistparser.h"
-#include "maddy/paragraphparser.h"
-#include "maddy/quoteparser.h"
-#include "maddy/tableparser.h"
-#include "maddy/unorderedlistparser.h"
-
-// LineParser
-#include "maddy/breaklineparser.h"
-#include "maddy/emphasizedparser.h"
-#include "maddy/imageparser.h"
-#include "maddy/inlinecodeparser.h"
-#include "maddy/italicparser.h"
-#include "maddy/linkparser.h"
-#include "maddy/strikethroughparser.h"
-#include "maddy/strongparser.h"
+#include "maddy/parserfeatures.h"
 
 // -----------------------------------------------------------------------------
 
@@ -41,11 +28,44 @@ namespace maddy {
 
 // -----------------------------------------------------------------------------
 
+/**
+ * DefaultParser
+ *
+ * `BasicParser` specialized at compile time for `maddy::types::DEFAULT` with
+ * headline inline parsing enabled.
+ */
+typedef BasicParser<StaticParserFeatures<maddy::types::DEFAULT>> DefaultParser;
+
+/**
+ * HighlightedParser
+ *
+ * `BasicParser` specialized at compile time for `maddy::types::HIGHLIGHTED`
+ * with headline inline parsing enabled.
+ */
+typedef BasicParser<StaticParserFeatures<maddy::types::HIGHLIGHTED>>
+  HighlightedParser;
+
+/**
+ * AllParser
+ *
+ * `BasicParser` specialized at compile time for `maddy::types::ALL` with
+ * headline inline parsing enabled.
+ */
+typedef BasicParser<StaticParserFeatures<maddy::types::ALL>> AllParser;
+
+// -----------------------------------------------------------------------------
+
 /**
  * Parser
  *
  * Transforms Markdown to HTML
  *
+ * A `Parser` is immutable after construction. Every call keeps its state in
+ * its own session and the shared `BlockCache` is locked, so one instance can
+ * be used by many threads at the same time. Constructing it is the expensive
+ * part, so keep it around (or get it from a `ParserPool`) instead of
+ * creating one per document.
+ *
  * @class
  */
 class Parser
@@ -66,58 +86,73 @@ public:
   /**
    * ctor
    *
-   * Initializes all `LineParser`
+   * Picks the parser implementation for the config. If the config is one of
+   * the presets `maddy::types::DEFAULT`, `maddy::types::HIGHLIGHTED` or
+   * `maddy::types::ALL` (with headline inline parsing enabled), the
+   * compile-time specialized `DefaultParser`, `HighlightedParser` or
+   * `AllParser` is used. The config is only read here, later changes to it
+   * have no effect on this parser.
    *
    * @method
    */
-  Parser(std::shared_ptr<ParserConfig> config = nullptr) : config(config)
+  Parser(std::shared_ptr<ParserConfig> config = nullptr)
+    : config(config)
+    , parallelParsingThreshold(ParserConfig().parallelParsingThreshold)
+    , parallelParsingThreadCount(0)
   {
-    if (!this->config ||
-        (this->config->enabledParsers & maddy::types::BREAKLINE_PARSER) != 0)
-    {
-      this->breakLineParser = std::make_shared<BreakLineParser>();
-    }
-
-    if (!this->config ||
-        (this->config->enabledParsers & maddy::types::EMPHASIZED_PARSER) != 0)
+    if (config)
     {
-      this->emphasizedParser = std::make_shared<EmphasizedParser>();
+      this->parallelParsingThreshold = config->parallelParsingThreshold;
+      this->parallelParsingThreadCount = config->parallelParsingThreadCount;
+      this->blockCache = config->blockCache;
     }
 
-    if (!this->config ||
-        (this->config->enabledParsers & maddy::types::IMAGE_PARSER) != 0)
-    {
-      this->imageParser = std::make_shared<ImageParser>();
-    }
+    const ParserLimits limits(config.get());
+    this->hasOutputLimit = limits.maxOutputSize != 0;
+
+    // everything in the config, which always changes the HTML the same way
+    const uint64_t settings[] = {
+      config ? config->enabledParsers : maddy::types::DEFAULT,
+      config ? config->isHeadlineInlineParsingEnabled : true,
+      limits.maxLineLength,
+      limits.maxNestingDepth
+    };
+    this->blockCacheKey = ContentHash::Compute(
+      reinterpret_cast<const char*>(settings), sizeof(settings)
+    );
 
-    if (!this->config ||
-        (this->config->enabledParsers & maddy::types::INLINE_CODE_PARSER) != 0)
+    if (this->parallelParsingThreadCount == 0)
     {
-      this->inlineCodeParser = std::make_shared<InlineCodeParser>();
+      this->parallelParsingThreadCount = std::thread::hardware_concurrency();
     }
 
-    if (!this->config ||
-        (this->config->enabledParsers & maddy::types::ITALIC_PARSER) != 0)
+    if (StaticParserFeatures<maddy::types::DEFAULT>::Matches(config.get()))
     {
-      this->italicParser = std::make_shared<ItalicParser>();
+      this->engine = std::make_shared<ParserEngineImpl<DefaultParser>>(
+        DefaultParser(StaticParserFeatures<maddy::types::DEFAULT>(), limits)
+      );
     }
-
-    if (!this->config ||
-        (this->config->enabledParsers & maddy::types::LINK_PARSER) != 0)
+    else if (StaticParserFeatures<maddy::types::HIGHLIGHTED>::Matches(
+               config.get()
+             ))
     {
-      this->linkParser = std::make_shared<LinkParser>();
+      this->engine = std::make_shared<ParserEngineImpl<HighlightedParser>>(
+        HighlightedParser(
+          StaticParserFeatures<maddy::types::HIGHLIGHTED>(), limits
+        )
+      );
     }
-
-    if (!this->config || (this->config->enabledParsers &
-                          maddy::types::STRIKETHROUGH_PARSER) != 0)
+    else if (StaticParserFeatures<maddy::types::ALL>::Matches(config.get()))
     {
-      this->strikeThroughParser = std::make_shared<StrikeThroughParser>();
+      this->engine = std::make_shared<ParserEngineImpl<AllParser>>(
+        AllParser(StaticParserFeatures<maddy::types::ALL>(), limits)
+      );
     }
-
-    if (!this->config ||
-        (this->config->enabledParsers & maddy::types::STRONG_PARSER) != 0)
+    else
     {
-      this->strongParser = std::make_shared<StrongParser>();
+      this->engine = std::make_shared<ParserEngineImpl<RuntimeParser>>(
+        RuntimeParser(RuntimeParserFeatures(config.get()), limits)
+      );
     }
   }
 
@@ -131,269 +166,363 @@ public:
   std::string Parse(std::istream& markdown) const
   {
     std::string result = "";
-    std::shared_ptr<BlockParser> currentBlockParser = nullptr;
+    StringOutputSink sink(result);
 
-    for (std::string line; std::getline(markdown, line);)
-    {
-      if (!currentBlockParser)
-      {
-        currentBlockParser = getBlockParserForLine(line);
-      }
+    this->engine->Parse(markdown, sink);
 
-      if (currentBlockParser)
-      {
-        currentBlockParser->AddLine(line);
+    return result;
+  }
 
-        if (currentBlockParser->IsFinished())
-        {
-          result += currentBlockParser->GetResult().str();
-          currentBlockParser = nullptr;
-        }
-      }
-    }
+  /**
+   * Parse
+   *
+   * Writes every finished block directly into the given sink.
+   *
+   * @method
+   * @param {const std::istream&} markdown
+   * @param {OutputSink&} sink
+   * @return {void}
+   */
+  void Parse(std::istream& markdown, OutputSink& sink) const
+  {
+    this->engine->Parse(markdown, sink);
+  }
 
-    // make sure, that all parsers are finished
-    if (currentBlockParser)
-    {
-      std::string emptyLine = "";
-      currentBlockParser->AddLine(emptyLine);
-      if (currentBlockParser->IsFinished())
-      {
-        result += currentBlockParser->GetResult().str();
-        currentBlockParser = nullptr;
-      }
-    }
+  /**
+   * Parse
+   *
+   * Parses a contiguous buffer without copying it into a stream first. Lines
+   * are split at `\n` the same way `std::getline` does it, so the result is
+   * identical to the `std::istream` overload. Each line is only materialized
+   * in one reused line buffer, because the block parsers rewrite it in place.
+   *
+   * @method
+   * @param {const char*} markdown
+   * @param {size_t} size
+   * @return {std::string} HTML
+   */
+  std::string Parse(const char* markdown, size_t size) const
+  {
+    std::string result = "";
+    StringOutputSink sink(result);
+
+    this->Parse(markdown, size, sink);
 
     return result;
   }
 
-private:
-  std::shared_ptr<ParserConfig> config;
-  std::shared_ptr<BreakLineParser> breakLineParser;
-  std::shared_ptr<EmphasizedParser> emphasizedParser;
-  std::shared_ptr<ImageParser> imageParser;
-  std::shared_ptr<InlineCodeParser> inlineCodeParser;
-  std::shared_ptr<ItalicParser> italicParser;
-  std::shared_ptr<LinkParser> linkParser;
-  std::shared_ptr<StrikeThroughParser> strikeThroughParser;
-  std::shared_ptr<StrongParser> strongParser;
-
-  // block parser have to run before
-  void runLineParser(std::string& line) const
+  /**
+   * Parse
+   *
+   * Writes every finished block directly into the given sink. Documents of
+   * at least `ParserConfig::parallelParsingThreshold` bytes are parsed on
+   * several threads, with the same output. Otherwise blocks are taken from
+   * the `ParserConfig::blockCache`, if there is one. With a
+   * `ParserConfig::maxOutputSize` neither is used, because the limit is
+   * counted over the whole document.
+   *
+   * @method
+   * @param {const char*} markdown
+   * @param {size_t} size
+   * @param {OutputSink&} sink
+   * @return {void}
+   */
+  void Parse(const char* markdown, size_t size, OutputSink& sink) const
   {
-    // Attention! ImageParser has to be before LinkParser
-    if (this->imageParser)
+    if (this->hasOutputLimit)
     {
-      this->imageParser->Parse(line);
+      this->engine->Parse(markdown, size, sink);
+      return;
     }
 
-    if (this->linkParser)
+    if (this->parallelParsingThreshold == 0 ||
+        size < this->parallelParsingThreshold ||
+        this->parallelParsingThreadCount < 2)
     {
-      this->linkParser->Parse(line);
-    }
+      if (this->blockCache)
+      {
+        this->engine->ParseCached(
+          markdown, size, sink, *this->blockCache, this->blockCacheKey
+        );
+      }
+      else
+      {
+        this->engine->Parse(markdown, size, sink);
+      }
 
-    // Attention! StrongParser has to be before EmphasizedParser
-    if (this->strongParser)
-    {
-      this->strongParser->Parse(line);
+      return;
     }
 
-    if (this->emphasizedParser)
-    {
-      this->emphasizedParser->Parse(line);
-    }
+    // a few chunks per thread, so that uneven chunks are balanced out
+    const size_t minChunkSize = 256 * 1024;
+    const size_t chunkSize =
+      std::max(size / (this->parallelParsingThreadCount * 4), minChunkSize);
 
-    if (this->strikeThroughParser)
-    {
-      this->strikeThroughParser->Parse(line);
-    }
+    this->engine->ParseParallel(
+      markdown, size, sink, this->parallelParsingThreadCount, chunkSize
+    );
+  }
 
-    if (this->inlineCodeParser)
-    {
-      this->inlineCodeParser->Parse(line);
-    }
+  /**
+   * Parse
+   *
+   * @method
+   * @param {const std::string&} markdown
+   * @return {std::string} HTML
+   */
+  std::string Parse(const std::string& markdown) const
+  {
+    return this->Parse(markdown.data(), markdown.size());
+  }
 
-    if (this->italicParser)
-    {
-      this->italicParser->Parse(line);
-    }
+  /**
+   * Parse
+   *
+   * @method
+   * @param {const std::string&} markdown
+   * @param {OutputSink&} sink
+   * @return {void}
+   */
+  void Parse(const std::string& markdown, OutputSink& sink) const
+  {
+    this->Parse(markdown.data(), markdown.size(), sink);
+  }
 
-    if (this->breakLineParser)
-    {
-      this->breakLineParser->Parse(line);
-    }
+  /**
+   * ParseTree
+   *
+   * Parses the Markdown into a flat `DocumentTree`, which can be given to
+   * several `DocumentRenderer`. The `HtmlRenderer` writes the same HTML as
+   * `Parse`. Always parses on one thread and without the block cache.
+   *
+   * @method
+   * @param {const char*} markdown
+   * @param {size_t} size
+   * @param {DocumentTree&} tree
+   * @return {bool} false and an empty tree, if the Markdown is larger than
+   * `DocumentTree::MAX_SOURCE_SIZE`
+   */
+  bool ParseTree(const char* markdown, size_t size, DocumentTree& tree) const
+  {
+    return this->engine->ParseTree(markdown, size, tree);
   }
 
-  std::shared_ptr<BlockParser> getBlockParserForLine(const std::string& line
+  /**
+   * ParseTree
+   *
+   * @method
+   * @param {const std::string&} markdown
+   * @param {DocumentTree&} tree
+   * @return {bool}
+   */
+  bool ParseTree(const std::string& markdown, DocumentTree& tree) const
+  {
+    return this->ParseTree(markdown.data(), markdown.size(), tree);
+  }
+
+  /**
+   * RenderTree
+   *
+   * Writes the HTML of a `DocumentTree`, which was parsed by this parser
+   * from `markdown`. The HTML is the same as the one of `Parse`. Usually
+   * called by the `HtmlRenderer`.
+   *
+   * @method
+   * @param {const char*} markdown
+   * @param {const DocumentTree&} tree
+   * @param {OutputSink&} sink
+   * @return {void}
+   */
+  void RenderTree(
+    const char* markdown, const DocumentTree& tree, OutputSink& sink
   ) const
   {
-    std::shared_ptr<BlockParser> parser;
+    this->engine->RenderTree(markdown, tree, sink);
+  }
 
-    if ((!this->config || (this->config->enabledParsers &
-                           maddy::types::CODE_BLOCK_PARSER) != 0) &&
-        maddy::CodeBlockParser::IsStartingLine(line))
-    {
-      parser = std::make_shared<maddy::CodeBlockParser>(nullptr, nullptr);
-    }
-    else if (this->config &&
-             (this->config->enabledParsers & maddy::types::LATEX_BLOCK_PARSER
-             ) != 0 &&
-             maddy::LatexBlockParser::IsStartingLine(line))
-    {
-      parser = std::make_shared<LatexBlockParser>(nullptr, nullptr);
-    }
-    else if ((!this->config || (this->config->enabledParsers &
-                                maddy::types::HEADLINE_PARSER) != 0) &&
-             maddy::HeadlineParser::IsStartingLine(line))
-    {
-      if (!this->config || this->config->isHeadlineInlineParsingEnabled)
-      {
-        parser = std::make_shared<maddy::HeadlineParser>(
-          [this](std::string& line) { this->runLineParser(line); },
-          nullptr,
-          true
-        );
-      }
-      else
-      {
-        parser =
-          std::make_shared<maddy::HeadlineParser>(nullptr, nullptr, false);
-      }
-    }
-    else if ((!this->config || (this->config->enabledParsers &
-                                maddy::types::HORIZONTAL_LINE_PARSER) != 0) &&
-             maddy::HorizontalLineParser::IsStartingLine(line))
+  /**
+   * ParseWithOutline
+   *
+   * Parses the Markdown like `Parse`, but every headline gets a unique `id`
+   * (a slug of its text) and is added to the `DocumentOutline` with its level,
+   * text and offsets. The document is parsed on one thread and without the
+   * block cache, because the slugs depend on all headlines before.
+   *
+   * @method
+   * @param {const char*} markdown
+   * @param {size_t} size
+   * @param {OutputSink&} sink
+   * @param {DocumentOutline&} outline
+   * @return {void}
+   */
+  void ParseWithOutline(
+    const char* markdown,
+    size_t size,
+    OutputSink& sink,
+    DocumentOutline& outline
+  ) const
+  {
+    this->engine->ParseWithOutline(markdown, size, sink, outline);
+  }
+
+  /**
+   * ParseWithOutline
+   *
+   * @method
+   * @param {const std::string&} markdown
+   * @param {OutputSink&} sink
+   * @param {DocumentOutline&} outline
+   * @return {void}
+   */
+  void ParseWithOutline(
+    const std::string& markdown, OutputSink& sink, DocumentOutline& outline
+  ) const
+  {
+    this->ParseWithOutline(markdown.data(), markdown.size(), sink, outline);
+  }
+
+  /**
+   * CreateSession
+   *
+   * Creates the state for parsing one document line by line. The parser and
+   * the sink have to outlive the session.
+   *
+   * @method
+   * @param {OutputSink&} sink
+   * @return {std::unique_ptr<ParserSession>}
+   */
+  std::unique_ptr<ParserSession> CreateSession(OutputSink& sink) const
+  {
+    return this->engine->CreateSession(sink);
+  }
+
+private:
+  typedef BasicParser<RuntimeParserFeatures> RuntimeParser;
+
+  class ParserEngine
+  {
+  public:
+    virtual ~ParserEngine() {}
+
+    virtual void Parse(std::istream& markdown, OutputSink& sink) const = 0;
+
+    virtual void Parse(const char* markdown, size_t size, OutputSink& sink)
+      const = 0;
+
+    virtual void ParseParallel(
+      const char* markdown,
+      size_t size,
+      OutputSink& sink,
+      size_t threadCount,
+      size_t chunkSize
+    ) const = 0;
+
+    virtual void ParseCached(
+      const char* markdown,
+      size_t size,
+      OutputSink& sink,
+      BlockCache& cache,
+      uint64_t settingsKey
+    ) const = 0;
+
+    virtual bool ParseTree(
+      const char* markdown, size_t size, DocumentTree& tree
+    ) const = 0;
+
+    virtual void RenderTree(
+      const char* markdown, const DocumentTree& tree, OutputSink& sink
+    ) const = 0;
+
+    virtual void ParseWithOutline(
+      const char* markdown,
+      size_t size,
+      OutputSink& sink,
+      DocumentOutline& outline
+    ) const = 0;
+
+    virtual std::unique_ptr<ParserSession> CreateSession(OutputSink& sink
+    ) const = 0;
+  }; // class ParserEngine
+
+  template <class ParserType>
+  class ParserEngineImpl final : public ParserEngine
+  {
+  public:
+    explicit ParserEngineImpl(const ParserType& parser) : parser(parser) {}
+
+    void Parse(std::istream& markdown, OutputSink& sink) const override
     {
-      parser = std::make_shared<maddy::HorizontalLineParser>(nullptr, nullptr);
+      this->parser.Parse(markdown, sink);
     }
-    else if ((!this->config || (this->config->enabledParsers &
-                                maddy::types::QUOTE_PARSER) != 0) &&
-             maddy::QuoteParser::IsStartingLine(line))
+
+    void Parse(const char* markdown, size_t size, OutputSink& sink)
+      const override
     {
-      parser = std::make_shared<maddy::QuoteParser>(
-        [this](std::string& line) { this->runLineParser(line); },
-        [this](const std::string& line)
-        { return this->getBlockParserForLine(line); }
-      );
+      this->parser.Parse(markdown, size, sink);
     }
-    else if ((!this->config || (this->config->enabledParsers &
-                                maddy::types::TABLE_PARSER) != 0) &&
-             maddy::TableParser::IsStartingLine(line))
+
+    void ParseParallel(
+      const char* markdown,
+      size_t size,
+      OutputSink& sink,
+      size_t threadCount,
+      size_t chunkSize
+    ) const override
     {
-      parser = std::make_shared<maddy::TableParser>(
-        [this](std::string& line) { this->runLineParser(line); }, nullptr
-      );
+      this->parser.ParseParallel(markdown, size, sink, threadCount, chunkSize);
     }
-    else if ((!this->config || (this->config->enabledParsers &
-                                maddy::types::CHECKLIST_PARSER) != 0) &&
-             maddy::ChecklistParser::IsStartingLine(line))
+
+    void ParseCached(
+      const char* markdown,
+      size_t size,
+      OutputSink& sink,
+      BlockCache& cache,
+      uint64_t settingsKey
+    ) const override
     {
-      parser = this->createChecklistParser();
+      this->parser.ParseCached(markdown, size, sink, cache, settingsKey);
     }
-    else if ((!this->config || (this->config->enabledParsers &
-                                maddy::types::ORDERED_LIST_PARSER) != 0) &&
-             maddy::OrderedListParser::IsStartingLine(line))
+
+    bool ParseTree(const char* markdown, size_t size, DocumentTree& tree)
+      const override
     {
-      parser = this->createOrderedListParser();
+      return this->parser.ParseTree(markdown, size, tree);
     }
-    else if ((!this->config || (this->config->enabledParsers &
-                                maddy::types::UNORDERED_LIST_PARSER) != 0) &&
-             maddy::UnorderedListParser::IsStartingLine(line))
+
+    void RenderTree(
+      const char* markdown, const DocumentTree& tree, OutputSink& sink
+    ) const override
     {
-      parser = this->createUnorderedListParser();
+      this->parser.RenderTree(markdown, tree, sink);
     }
-    else if (this->config &&
-             (this->config->enabledParsers & maddy::types::HTML_PARSER) != 0 &&
-             maddy::HtmlParser::IsStartingLine(line))
+
+    void ParseWithOutline(
+      const char* markdown,
+      size_t size,
+      OutputSink& sink,
+      DocumentOutline& outline
+    ) const override
     {
-      parser = std::make_shared<maddy::HtmlParser>(nullptr, nullptr);
+      this->parser.ParseWithOutline(markdown, size, sink, outline);
     }
-    else if (maddy::ParagraphParser::IsStartingLine(line))
+
+    std::unique_ptr<ParserSession> CreateSession(OutputSink& sink
+    ) const override
     {
-      parser = std::make_shared<maddy::ParagraphParser>(
-        [this](std::string& line) { this->runLineParser(line); },
-        nullptr,
-        (!this->config ||
-         (this->config->enabledParsers & maddy::types::PARAGRAPH_PARSER) != 0)
-      );
+      return this->parser.CreateSession(sink);
     }
 
-    return parser;
-  }
-
-  std::shared_ptr<BlockParser> createChecklistParser() const
-  {
-    return std::make_shared<maddy::ChecklistParser>(
-      [this](std::string& line) { this->runLineParser(line); },
-      [this](const std::string& line)
-      {
-        std::shared_ptr<BlockParser> parser;
-
-        if ((!this->config || (this->config->enabledParsers &
-                               maddy::types::CHECKLIST_PARSER) != 0) &&
-            maddy::ChecklistParser::IsStartingLine(line))
-        {
-          parser = this->createChecklistParser();
-        }
-
-        return parser;
-      }
-    );
-  }
-
-  std::shared_ptr<BlockParser> createOrderedListParser() const
-  {
-    return std::make_shared<maddy::OrderedListParser>(
-      [this](std::string& line) { this->runLineParser(line); },
-      [this](const std::string& line)
-      {
-        std::shared_ptr<BlockParser> parser;
-
-        if ((!this->config || (this->config->enabledParsers &
-                               maddy::types::ORDERED_LIST_PARSER) != 0) &&
-            maddy::OrderedListParser::IsStartingLine(line))
-        {
-          parser = this->createOrderedListParser();
-        }
-        else if ((!this->config || (this->config->enabledParsers &
-                                    maddy::types::UNORDERED_LIST_PARSER) != 0
-                 ) &&
-                 maddy::UnorderedListParser::IsStartingLine(line))
-        {
-          parser = this->createUnorderedListParser();
-        }
-
-        return parser;
-      }
-    );
-  }
+  private:
+    ParserType parser;
+  }; // class ParserEngineImpl
 
-  std::shared_ptr<BlockParser> createUnorderedListParser() const
-  {
-    return std::make_shared<maddy::UnorderedListParser>(
-      [this](std::string& line) { this->runLineParser(line); },
-      [this](const std::string& line)
-      {
-        std::shared_ptr<BlockParser> parser;
-
-        if ((!this->config || (this->config->enabledParsers &
-                               maddy::types::ORDERED_LIST_PARSER) != 0) &&
-            maddy::OrderedListParser::IsStartingLine(line))
-        {
-          parser = this->createOrderedListParser();
-        }
-        else if ((!this->config || (this->config->enabledParsers &
-                                    maddy::types::UNORDERED_LIST_PARSER) != 0
-                 ) &&
-                 maddy::UnorderedListParser::IsStartingLine(line))
-        {
-          parser = this->createUnorderedListParser();
-        }
-
-        return parser;
-      }
-    );
-  }
+  std::shared_ptr<ParserConfig> config;
+  std::shared_ptr<const ParserEngine> engine;
+  size_t parallelParsingThreshold;
+  size_t parallelParsingThreadCount;
+  bool hasOutputLimit;
+  std::shared_ptr<BlockCache> blockCache;
+  uint64_t blockCacheKey;
 }; // class Parser
 
 // -----------------------------------------------------------------------------
@@ -0,0 +1,218 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <chrono>
+#include <cstddef>
+
+#include "maddy/parserconfig.h"
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * ParserLimits
+ *
+ * The resource limits of a `ParserConfig`, 0 means no limit.
+ *
+ * @class
+ */
+struct ParserLimits
+{
+  size_t maxLineLength;
+  size_t maxNestingDepth;
+  size_t maxOutputSize;
+  uint32_t timeLimit;
+
+  ParserLimits()
+    : maxLineLength(0)
+    , maxNestingDepth(0)
+    , maxOutputSize(0)
+    , timeLimit(0)
+  {}
+
+  explicit ParserLimits(const ParserConfig* config) : ParserLimits()
+  {
+    if (config)
+    {
+      this->maxLineLength = config->maxLineLength;
+      this->maxNestingDepth = config->maxNestingDepth;
+      this->maxOutputSize = config->maxOutputSize;
+      this->timeLimit = config->timeLimit;
+    }
+  }
+
+  /**
+   * IsNestingTooDeep
+   *
+   * @method
+   * @param {size_t} depth of a block, 0 for top-level blocks
+   * @return {bool}
+   */
+  bool IsNestingTooDeep(size_t depth) const
+  {
+    return this->maxNestingDepth != 0 && depth >= this->maxNestingDepth;
+  }
+
+  /**
+   * IsLineTooLong
+   *
+   * @method
+   * @param {size_t} size
+   * @return {bool}
+   */
+  bool IsLineTooLong(size_t size) const
+  {
+    return this->maxLineLength != 0 && size > this->maxLineLength;
+  }
+}; // struct ParserLimits
+
+// -----------------------------------------------------------------------------
+
+/**
+ * ParserBudget
+ *
+ * Tracks the output size and the time of one parse against its
+ * `ParserLimits`. Once one of them is used up, the budget stays exhausted
+ * until it is reset.
+ *
+ * The output size includes the pending HTML of the open block, so a large
+ * block uses up the budget while it is parsed and not only when it is
+ * written.
+ *
+ * @class
+ */
+class ParserBudget
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   * @param {const ParserLimits&} limits
+   */
+  explicit ParserBudget(const ParserLimits& limits)
+    : limits(limits)
+  {
+    this->Reset();
+  }
+
+  /**
+   * Reset
+   *
+   * Starts a new parse.
+   *
+   * @method
+   * @return {void}
+   */
+  void Reset()
+  {
+    this->outputSize = 0;
+    this->pendingOutputSize = 0;
+    this->isExhausted = false;
+    this->isOutputLimitReached = false;
+    this->start = std::chrono::steady_clock::now();
+  }
+
+  /**
+   * AddOutput
+   *
+   * @method
+   * @param {size_t} size of the written HTML
+   * @return {void}
+   */
+  void AddOutput(size_t size) { this->outputSize += size; }
+
+  /**
+   * SetPendingOutput
+   *
+   * @method
+   * @param {size_t} size of the HTML of the open block, which is not written
+   * yet
+   * @return {void}
+   */
+  void SetPendingOutput(size_t size) { this->pendingOutputSize = size; }
+
+  /**
+   * GetRemainingOutput
+   *
+   * @method
+   * @return {size_t} how many bytes of HTML can still be written, including
+   * the pending HTML, `SIZE_MAX` if there is no limit
+   */
+  size_t GetRemainingOutput() const
+  {
+    if (this->limits.maxOutputSize == 0)
+    {
+      return SIZE_MAX;
+    }
+
+    const size_t size = this->outputSize + this->pendingOutputSize;
+
+    return size < this->limits.maxOutputSize
+             ? this->limits.maxOutputSize - size
+             : 0;
+  }
+
+  /**
+   * IsOutputLimitReached
+   *
+   * @method
+   * @return {bool} if the budget was exhausted by the output size, in this
+   * case nothing more is written
+   */
+  bool IsOutputLimitReached()
+  {
+    return this->IsExhausted() && this->isOutputLimitReached;
+  }
+
+  /**
+   * IsExhausted
+   *
+   * @method
+   * @return {bool} if the output size or the time limit was exceeded
+   */
+  bool IsExhausted()
+  {
+    if (this->isExhausted)
+    {
+      return true;
+    }
+
+    if (this->limits.maxOutputSize != 0 &&
+        this->outputSize + this->pendingOutputSize >
+          this->limits.maxOutputSize)
+    {
+      this->isExhausted = true;
+      this->isOutputLimitReached = true;
+    }
+    else if (this->limits.timeLimit != 0 &&
+             std::chrono::steady_clock::now() - this->start >
+               std::chrono::milliseconds(this->limits.timeLimit))
+    {
+      this->isExhausted = true;
+    }
+
+    return this->isExhausted;
+  }
+
+private:
+  const ParserLimits& limits;
+  size_t outputSize;
+  size_t pendingOutputSize;
+  bool isExhausted;
+  bool isOutputLimitReached;
+  std::chrono::steady_clock::time_point start;
+}; // class ParserBudget
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
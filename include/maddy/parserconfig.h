@@ -5,6 +5,8 @@
 #pragma once
 
 #include <stdint.h>
+#include <cstddef>
+#include <memory>
 
 // -----------------------------------------------------------------------------
 
@@ -43,14 +45,20 @@ enum PARSER_TYPE : uint32_t
   TABLE_PARSER             = 0b10000000000000000,
   UNORDERED_LIST_PARSER    = 0b100000000000000000,
   LATEX_BLOCK_PARSER       = 0b1000000000000000000,
+  PIPE_TABLE_PARSER        = 0b10000000000000000000,
+  CODE_HIGHLIGHT_PARSER    = 0b100000000000000000000,
 
-  DEFAULT                  = 0b0111111111110111111,
-  ALL                      = 0b1111111111111111111,
+  DEFAULT                  = 0b010111111111110111111,
+  // DEFAULT with highlighted code blocks, as used by the viewers
+  HIGHLIGHTED              = 0b110111111111110111111,
+  ALL                      = 0b111111111111111111111,
 };
 // clang-format on
 
 } // namespace types
 
+class BlockCache;
+
 /**
  * ParserConfig
  *
@@ -70,9 +78,90 @@ struct ParserConfig
    */
   uint32_t enabledParsers;
 
+  /**
+   * documents of at least this size (in bytes) are parsed on several threads,
+   * 0 disables parallel parsing
+   *
+   * Only used by the `Parse` overloads for buffers and strings.
+   *
+   * default: 4 MiB
+   */
+  size_t parallelParsingThreshold;
+
+  /**
+   * number of threads for parallel parsing, 0 uses all hardware threads
+   *
+   * default: 0
+   */
+  size_t parallelParsingThreadCount;
+
+  /**
+   * memo cache for the HTML of blocks (see `maddy/blockcache.h`), which can
+   * be shared by several parsers
+   *
+   * Only used by the `Parse` overloads for buffers and strings. Documents,
+   * which are parsed in parallel, do not use the cache.
+   *
+   * default: none
+   */
+  std::shared_ptr<BlockCache> blockCache;
+
+  /**
+   * lines longer than this (in bytes) are written as escaped plain text,
+   * 0 means no limit
+   *
+   * default: 0
+   */
+  size_t maxLineLength;
+
+  /**
+   * maximum number of nested block levels, e.g. 2 allows a list in a quote
+   * but no list in a list in a quote, 0 means no limit
+   *
+   * Lines, which would start a deeper block, are content of the innermost
+   * allowed block.
+   *
+   * default: 0
+   */
+  size_t maxNestingDepth;
+
+  /**
+   * maximum size of the HTML in bytes, 0 means no limit
+   *
+   * Once the HTML of the written blocks and of the open block exceeds it,
+   * the open block is written as far as it got and the rest of the document
+   * is dropped. So the output is at most this size plus the HTML of one
+   * line. The body of code, HTML and LaTeX blocks is checked in parts, whose
+   * source is not larger than the rest of the limit, there the output can
+   * grow by the HTML of one part instead, e.g. by escaped characters.
+   * Documents with this limit are always parsed on one thread and without
+   * the block cache.
+   *
+   * default: 0
+   */
+  size_t maxOutputSize;
+
+  /**
+   * after this many milliseconds the rest of the document is written as
+   * escaped plain text, 0 means no limit
+   *
+   * The limits are checked between lines and at least every 64 KiB in the
+   * body of code, HTML and LaTeX blocks. Parallel parsing and the block
+   * cache apply `timeLimit` to every chunk or uncached part on its own.
+   *
+   * default: 0
+   */
+  uint32_t timeLimit;
+
   ParserConfig()
     : isHeadlineInlineParsingEnabled(true)
     , enabledParsers(maddy::types::DEFAULT)
+    , parallelParsingThreshold(4 * 1024 * 1024)
+    , parallelParsingThreadCount(0)
+    , maxLineLength(0)
+    , maxNestingDepth(0)
+    , maxOutputSize(0)
+    , timeLimit(0)
   {}
 }; // class ParserConfig
 
@@ -0,0 +1,189 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+
+#include "maddy/parserconfig.h"
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * RuntimeParserFeatures
+ *
+ * Feature set of a `BasicParser`, which is read from a `ParserConfig` at
+ * runtime.
+ *
+ * Without a config, all parsers of `maddy::types::DEFAULT` are enabled.
+ *
+ * @class
+ */
+class RuntimeParserFeatures
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   * @param {const ParserConfig*} config
+   */
+  explicit RuntimeParserFeatures(const ParserConfig* config = nullptr)
+    : enabledParsers(config ? config->enabledParsers : maddy::types::DEFAULT)
+    , isHeadlineInlineParsingEnabled(
+        config ? config->isHeadlineInlineParsingEnabled : true
+      )
+  {}
+
+  /**
+   * IsEnabled
+   *
+   * @method
+   * @param {uint32_t} parserType
+   * @return {bool}
+   */
+  bool IsEnabled(uint32_t parserType) const
+  {
+    return (this->enabledParsers & parserType) != 0;
+  }
+
+  /**
+   * IsHeadlineInlineParsingEnabled
+   *
+   * @method
+   * @return {bool}
+   */
+  bool IsHeadlineInlineParsingEnabled() const
+  {
+    return this->isHeadlineInlineParsingEnabled;
+  }
+
+private:
+  uint32_t enabledParsers;
+  bool isHeadlineInlineParsingEnabled;
+}; // class RuntimeParserFeatures
+
+// -----------------------------------------------------------------------------
+
+/**
+ * StaticParserFeatures
+ *
+ * Feature set of a `BasicParser`, which is fixed at compile time. All checks
+ * are constant expressions, so the code for disabled parsers is removed by
+ * the compiler.
+ *
+ * @class
+ */
+template <uint32_t EnabledParsers, bool HeadlineInlineParsing = true>
+class StaticParserFeatures
+{
+public:
+  /**
+   * Matches
+   *
+   * Checks if a config describes exactly this feature set.
+   *
+   * @method
+   * @param {const ParserConfig*} config
+   * @return {bool}
+   */
+  static bool Matches(const ParserConfig* config)
+  {
+    if (!config)
+    {
+      return EnabledParsers == maddy::types::DEFAULT && HeadlineInlineParsing;
+    }
+
+    return config->enabledParsers == EnabledParsers &&
+           config->isHeadlineInlineParsingEnabled == HeadlineInlineParsing;
+  }
+
+  /**
+   * IsEnabled
+   *
+   * @method
+   * @param {uint32_t} parserType
+   * @return {bool}
+   */
+  static constexpr bool IsEnabled(uint32_t parserType)
+  {
+    return (EnabledParsers & parserType) != 0;
+  }
+
+  /**
+   * IsHeadlineInlineParsingEnabled
+   *
+   * @method
+   * @return {bool}
+   */
+  static constexpr bool IsHeadlineInlineParsingEnabled()
+  {
+    return HeadlineInlineParsing;
+  }
+}; // class StaticParserFeatures
+
+// -----------------------------------------------------------------------------
+
+/**
+ * PlannedParserFeatures
+ *
+ * The feature set of a `BasicParser` narrowed down to the parsers, which can
+ * match in the current document (see `DocumentPlan`).
+ *
+ * @class
+ */
+template <class Features>
+class PlannedParserFeatures
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   * @param {const Features&} features has to outlive this object
+   * @param {uint32_t} possibleParsers
+   */
+  PlannedParserFeatures(const Features& features, uint32_t possibleParsers)
+    : features(features)
+    , possibleParsers(possibleParsers)
+  {}
+
+  /**
+   * IsEnabled
+   *
+   * @method
+   * @param {uint32_t} parserType
+   * @return {bool}
+   */
+  bool IsEnabled(uint32_t parserType) const
+  {
+    return this->features.IsEnabled(parserType) &&
+           (this->possibleParsers & parserType) != 0;
+  }
+
+  /**
+   * IsHeadlineInlineParsingEnabled
+   *
+   * @method
+   * @return {bool}
+   */
+  bool IsHeadlineInlineParsingEnabled() const
+  {
+    return this->features.IsHeadlineInlineParsingEnabled();
+  }
+
+private:
+  const Features& features;
+  uint32_t possibleParsers;
+}; // class PlannedParserFeatures
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
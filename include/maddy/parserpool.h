@@ -0,0 +1,211 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include "maddy/blockcache.h"
+#include "maddy/outputsink.h"
+#include "maddy/parser.h"
+#include "maddy/parserconfig.h"
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * ParserPool
+ *
+ * Hands out one shared, ready to use `Parser` per config. Configs with the
+ * same values get the same parser, so a renderer can ask the pool for every
+ * document without constructing a parser each time. As a `Parser` can be used
+ * by many threads at once, the pool never has to hand out more than one
+ * parser per config.
+ *
+ * New parsers are warmed up with a small document, which starts every block
+ * parser, a pipe table and a highlighted code block once. This builds the
+ * lookup tables, which are created on first use (the byte scanners, the
+ * block classifier and the lexers of the `SyntaxHighlighter`), so that the
+ * first real document does not pay for them. The per-depth block parser
+ * sets and line buffers belong to each parse, they are allocated by every
+ * parse once. All methods are thread-safe.
+ *
+ * ```
+ * static maddy::ParserPool parserPool;
+ * std::shared_ptr<const maddy::Parser> parser = parserPool.Get(config);
+ * std::string html = parser->Parse(markdown);
+ * ```
+ *
+ * @class
+ */
+class ParserPool
+{
+public:
+  /**
+   * Get
+   *
+   * @method
+   * @param {std::shared_ptr<ParserConfig>} config is only read, later changes
+   * to it have no effect on the returned parser
+   * @return {std::shared_ptr<const Parser>}
+   */
+  std::shared_ptr<const Parser> Get(
+    std::shared_ptr<ParserConfig> config = nullptr
+  )
+  {
+    const Key key = getKey(config.get());
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    auto it = this->parsers.find(key);
+
+    if (it != this->parsers.end())
+    {
+      return it->second;
+    }
+
+    std::shared_ptr<const Parser> parser = std::make_shared<Parser>(config);
+    warmUp(*parser);
+    this->parsers[key] = parser;
+
+    return parser;
+  }
+
+  /**
+   * GetParserCount
+   *
+   * @method
+   * @return {size_t}
+   */
+  size_t GetParserCount() const
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->parsers.size();
+  }
+
+  /**
+   * Clear
+   *
+   * Parsers, which were already handed out, stay valid.
+   *
+   * @method
+   * @return {void}
+   */
+  void Clear()
+  {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->parsers.clear();
+  }
+
+private:
+  // everything in the config, which is read by the parser
+  typedef std::tuple<
+    bool,
+    uint32_t,
+    size_t,
+    size_t,
+    const BlockCache*,
+    size_t,
+    size_t,
+    size_t,
+    uint32_t>
+    Key;
+
+  mutable std::mutex mutex;
+  std::map<Key, std::shared_ptr<const Parser>> parsers;
+
+  static Key getKey(const ParserConfig* config)
+  {
+    // no config behaves like the default config
+    const ParserConfig defaultConfig;
+
+    if (!config)
+    {
+      config = &defaultConfig;
+    }
+
+    return Key(
+      config->isHeadlineInlineParsingEnabled,
+      config->enabledParsers,
+      config->parallelParsingThreshold,
+      config->parallelParsingThreadCount,
+      config->blockCache.get(),
+      config->maxLineLength,
+      config->maxNestingDepth,
+      config->maxOutputSize,
+      config->timeLimit
+    );
+  }
+
+  static void warmUp(const Parser& parser)
+  {
+    static const char* const lines[] = {
+      "# headline *a* **b** _c_ __d__ ~~e~~ `f` [g](h) ![i](j)",
+      "",
+      "paragraph *a* **b** _c_ __d__ ~~e~~ `f` [g](h) ![i](j)",
+      "",
+      "- unordered",
+      "  1. ordered",
+      "",
+      "- [ ] checklist",
+      "- [x] checklist",
+      "",
+      "```",
+      "code",
+      "```",
+      "",
+      "$$",
+      "latex",
+      "$$",
+      "",
+      "|table>",
+      "a|b",
+      "|<table",
+      "",
+      "|a|b|",
+      "|-|-|",
+      "|c|d|",
+      "",
+      "```cpp",
+      "int code = 0; // \"highlighted\"",
+      "```",
+      "",
+      "---",
+      "",
+      // a quote stays open until the end of the document
+      "> quote",
+      "",
+      "<div>",
+      ""
+    };
+
+    // a session does not use the block cache, so it stays untouched
+    std::string html;
+    StringOutputSink sink(html);
+    std::unique_ptr<ParserSession> session = parser.CreateSession(sink);
+    std::string line;
+
+    for (const char* text : lines)
+    {
+      line = text;
+      session->AddLine(line);
+    }
+
+    session->Finish();
+  }
+}; // class ParserPool
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
@@ -0,0 +1,453 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "maddy/blockparser.h"
+#include "maddy/bytescanner.h"
+#include "maddy/paragraphparser.h"
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * PipeTableParser
+ *
+ * From Markdown: a GitHub Flavored Markdown table, a header row, a delimiter
+ * row with the alignment of every column and the body rows up to the next
+ * empty line
+ *
+ * ```
+ * | name | value | note |
+ * |:-----|------:|:----:|
+ * | a    | 1     | x \| y |
+ * ```
+ *
+ * To HTML:
+ *
+ * ```
+ * <table><thead><tr><th align="left">name</th><th align="right">value</th>
+ * <th align="center">note</th></tr></thead><tbody><tr><td align="left">a</td>
+ * <td align="right">1</td><td align="center">x | y</td></tr></tbody></table>
+ * ```
+ *
+ * The table has to start with `|`, the other rows can omit the outer pipes.
+ * Missing cells of a row are empty, additional cells are dropped. If the
+ * second line is no delimiter row with as many cells as the header, the lines
+ * are a paragraph.
+ *
+ * Every row is written as soon as it is added. Only the header line is kept
+ * until the delimiter row arrives, the cells of a row are offsets into the
+ * line, so the memory used does not depend on the number of rows.
+ *
+ * @class
+ */
+class PipeTableParser : public BlockParser
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   * @param {std::function<void(std::string&)>} parseLineCallback
+   * @param {std::function<BlockParser*(const std::string& line)>}
+   * getBlockParserForLineCallback
+   * @param {bool} isParagraphEnabled for lines, which are no table
+   */
+  PipeTableParser(
+    std::function<void(std::string&)> parseLineCallback,
+    std::function<BlockParser*(const std::string& line)>
+      getBlockParserForLineCallback,
+    bool isParagraphEnabled
+  )
+    : BlockParser(parseLineCallback, getBlockParserForLineCallback)
+    , paragraphParser(parseLineCallback, nullptr, isParagraphEnabled)
+    , state(HEADER_STATE)
+    , hasBody(false)
+  {}
+
+  /**
+   * IsStartingLine
+   *
+   * A table starts with `|`. Whether it is a table, is only known with the
+   * next line.
+   *
+   * @method
+   * @param {const std::string&} line
+   * @return {bool}
+   */
+  static bool IsStartingLine(const std::string& line)
+  {
+    return !line.empty() && line[0] == '|';
+  }
+
+  /**
+   * AddLine
+   *
+   * @method
+   * @param {std::string&} line
+   * @return {void}
+   */
+  void AddLine(std::string& line) override
+  {
+    switch (this->state)
+    {
+      case HEADER_STATE:
+        this->headerLine = line;
+        this->state = DELIMITER_STATE;
+        break;
+      case DELIMITER_STATE:
+        if (this->parseAlignments(line) && this->writeHeader())
+        {
+          this->state = BODY_STATE;
+          break;
+        }
+
+        // no table: the lines are a paragraph as they would be without
+        // this parser
+        this->state = PARAGRAPH_STATE;
+        this->paragraphParser.Reset();
+        this->paragraphParser.GetResult().ShareWith(this->result);
+        this->paragraphParser.AddLine(this->headerLine);
+        this->paragraphParser.AddLine(line);
+        break;
+      case BODY_STATE:
+        this->parseBlock(line);
+        break;
+      case PARAGRAPH_STATE:
+        this->paragraphParser.AddLine(line);
+        break;
+      case FINISHED_STATE:
+        break;
+    }
+  }
+
+  /**
+   * IsFinished
+   *
+   * A table ends with an empty line.
+   *
+   * @method
+   * @return {bool}
+   */
+  bool IsFinished() const override
+  {
+    return this->state == FINISHED_STATE ||
+           (this->state == PARAGRAPH_STATE &&
+            this->paragraphParser.IsFinished());
+  }
+
+  /**
+   * Reset
+   *
+   * @method
+   * @return {void}
+   */
+  void Reset() override
+  {
+    BlockParser::Reset();
+    this->state = HEADER_STATE;
+    this->hasBody = false;
+    this->headerLine.clear();
+    this->alignments.clear();
+  }
+
+protected:
+  bool isInlineBlockAllowed() const override { return false; }
+
+  bool isLineParserAllowed() const override { return true; }
+
+  // a body row
+  void parseBlock(std::string& line) override
+  {
+    if (line.empty())
+    {
+      this->result << (this->hasBody ? "</tbody></table>" : "</table>");
+      this->state = FINISHED_STATE;
+      return;
+    }
+
+    if (!this->hasBody)
+    {
+      this->result << "<tbody>";
+      this->hasBody = true;
+    }
+
+    this->splitRow(line);
+    this->writeRow(line, "<td", "</td>");
+  }
+
+private:
+  enum State
+  {
+    HEADER_STATE,
+    DELIMITER_STATE,
+    BODY_STATE,
+    PARAGRAPH_STATE,
+    FINISHED_STATE
+  };
+
+  enum Alignment : uint8_t
+  {
+    NO_ALIGNMENT,
+    LEFT_ALIGNMENT,
+    CENTER_ALIGNMENT,
+    RIGHT_ALIGNMENT
+  };
+
+  ParagraphParser paragraphParser;
+  State state;
+  bool hasBody;
+  std::string headerLine;
+  // one entry per column
+  std::vector<Alignment> alignments;
+  // begin and end of every cell in the current row
+  std::vector<size_t> cellBounds;
+  std::string cell;
+
+  static bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+  static bool isEscaped(const std::string& line, size_t pos)
+  {
+    return pos > 0 && line[pos - 1] == '\\';
+  }
+
+  /**
+   * splitRow
+   *
+   * Stores the trimmed cells of the row in `cellBounds`. Outer pipes are
+   * optional, `\|` does not split.
+   */
+  void splitRow(const std::string& line)
+  {
+    static const ByteScanner pipeScanner("|");
+
+    size_t begin = 0;
+    size_t end = line.size();
+
+    while (begin < end && isSpace(line[begin]))
+    {
+      ++begin;
+    }
+
+    while (end > begin && isSpace(line[end - 1]))
+    {
+      --end;
+    }
+
+    if (begin < end && line[begin] == '|')
+    {
+      ++begin;
+    }
+
+    if (end > begin && line[end - 1] == '|' && !isEscaped(line, end - 1))
+    {
+      --end;
+    }
+
+    this->cellBounds.clear();
+    const char* data = line.data();
+    size_t cellBegin = begin;
+
+    for (;;)
+    {
+      size_t cellEnd = static_cast<size_t>(
+        pipeScanner.Find(data + cellBegin, data + end) - data
+      );
+
+      while (cellEnd < end && isEscaped(line, cellEnd))
+      {
+        cellEnd = static_cast<size_t>(
+          pipeScanner.Find(data + cellEnd + 1, data + end) - data
+        );
+      }
+
+      size_t trimmedBegin = cellBegin;
+      size_t trimmedEnd = cellEnd;
+
+      while (trimmedBegin < trimmedEnd && isSpace(line[trimmedBegin]))
+      {
+        ++trimmedBegin;
+      }
+
+      while (trimmedEnd > trimmedBegin && isSpace(line[trimmedEnd - 1]))
+      {
+        --trimmedEnd;
+      }
+
+      this->cellBounds.push_back(trimmedBegin);
+      this->cellBounds.push_back(trimmedEnd);
+
+      if (cellEnd >= end)
+      {
+        return;
+      }
+
+      cellBegin = cellEnd + 1;
+    }
+  }
+
+  // reads the delimiter row, e.g. `| :--- | ---: |`
+  bool parseAlignments(const std::string& line)
+  {
+    if (line.find('|') == std::string::npos)
+    {
+      return false;
+    }
+
+    this->splitRow(line);
+    this->alignments.clear();
+
+    for (size_t i = 0; i < this->cellBounds.size(); i += 2)
+    {
+      size_t begin = this->cellBounds[i];
+      size_t end = this->cellBounds[i + 1];
+      const bool isLeft = begin < end && line[begin] == ':';
+      const bool isRight = end > begin + isLeft && line[end - 1] == ':';
+
+      begin += isLeft;
+      end -= isRight;
+
+      if (begin == end)
+      {
+        return false;
+      }
+
+      for (size_t pos = begin; pos < end; ++pos)
+      {
+        if (line[pos] != '-')
+        {
+          return false;
+        }
+      }
+
+      if (isLeft && isRight)
+      {
+        this->alignments.push_back(CENTER_ALIGNMENT);
+      }
+      else if (isLeft)
+      {
+        this->alignments.push_back(LEFT_ALIGNMENT);
+      }
+      else if (isRight)
+      {
+        this->alignments.push_back(RIGHT_ALIGNMENT);
+      }
+      else
+      {
+        this->alignments.push_back(NO_ALIGNMENT);
+      }
+    }
+
+    return true;
+  }
+
+  bool writeHeader()
+  {
+    this->splitRow(this->headerLine);
+
+    if (this->cellBounds.size() != 2 * this->alignments.size())
+    {
+      return false;
+    }
+
+    this->result << "<table><thead>";
+    this->writeRow(this->headerLine, "<th", "</th>");
+    this->result << "</thead>";
+    this->headerLine.clear();
+
+    return true;
+  }
+
+  // writes the cells of `cellBounds`, one per column
+  void writeRow(const std::string& line, const char* open, const char* close)
+  {
+    this->result << "<tr>";
+
+    for (size_t column = 0; column < this->alignments.size(); ++column)
+    {
+      this->cell.clear();
+
+      if (2 * column < this->cellBounds.size())
+      {
+        this->appendCell(
+          line, this->cellBounds[2 * column], this->cellBounds[2 * column + 1]
+        );
+        this->parseLine(this->cell);
+      }
+
+      this->result << open;
+
+      switch (this->alignments[column])
+      {
+        case LEFT_ALIGNMENT:
+          this->result << " align=\"left\"";
+          break;
+        case CENTER_ALIGNMENT:
+          this->result << " align=\"center\"";
+          break;
+        case RIGHT_ALIGNMENT:
+          this->result << " align=\"right\"";
+          break;
+        case NO_ALIGNMENT:
+          break;
+      }
+
+      this->result << ">";
+      this->result << this->cell;
+      this->result << close;
+    }
+
+    this->result << "</tr>";
+  }
+
+  // copies the cell into `cell`, `\|` becomes `|`
+  void appendCell(const std::string& line, size_t begin, size_t end)
+  {
+    const char* data = line.data();
+
+    while (begin < end)
+    {
+      const char* backslash = static_cast<const char*>(
+        std::memchr(data + begin, '\\', end - begin)
+      );
+
+      if (!backslash || backslash + 1 >= data + end)
+      {
+        this->cell.append(data + begin, end - begin);
+        return;
+      }
+
+      const size_t escape = static_cast<size_t>(backslash - data);
+
+      if (data[escape + 1] == '|')
+      {
+        this->cell.append(data + begin, escape - begin);
+        this->cell += '|';
+      }
+      else
+      {
+        this->cell.append(data + begin, escape + 2 - begin);
+      }
+
+      begin = escape + 2;
+    }
+  }
+}; // class PipeTableParser
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
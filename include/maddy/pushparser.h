@@ -0,0 +1,144 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <cstring>
+#include <memory>
+#include <string>
+
+#include "maddy/outputsink.h"
+#include "maddy/parser.h"
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * PushParser
+ *
+ * Push-style counterpart to `Parser::Parse`. The Markdown can be fed in
+ * arbitrary chunks, which do not have to end at line boundaries. Every block
+ * is written to the sink as soon as it is finished, so rendering can start
+ * before the whole input has been read. Open blocks (code blocks, lists,
+ * quotes, ...) stay open across chunks.
+ *
+ * The `Parser` and the `OutputSink` have to outlive the `PushParser`.
+ *
+ * ```
+ * maddy::PushParser pushParser(parser, sink);
+ * while (size_t size = read(buffer))
+ * {
+ *   pushParser.Feed(buffer, size);
+ * }
+ * pushParser.Finish();
+ * ```
+ *
+ * @class
+ */
+class PushParser
+{
+public:
+  /**
+   * ctor
+   *
+   * @method
+   * @param {const Parser&} parser
+   * @param {OutputSink&} sink
+   */
+  PushParser(const Parser& parser, OutputSink& sink)
+    : session(parser.CreateSession(sink))
+  {}
+
+  /**
+   * Feed
+   *
+   * Parses all lines completed by this chunk. An incomplete last line is
+   * kept until the next chunk or `Finish` arrives.
+   *
+   * @method
+   * @param {const char*} markdown
+   * @param {size_t} size
+   * @return {void}
+   */
+  void Feed(const char* markdown, size_t size)
+  {
+    const char* current = markdown;
+    const char* end = markdown + size;
+
+    while (current < end)
+    {
+      const char* lineEnd = static_cast<const char*>(
+        std::memchr(current, '\n', static_cast<size_t>(end - current))
+      );
+
+      if (!lineEnd)
+      {
+        this->pendingLine.append(current, end);
+        return;
+      }
+
+      if (this->pendingLine.empty())
+      {
+        this->line.assign(current, lineEnd);
+      }
+      else
+      {
+        this->pendingLine.append(current, lineEnd);
+        this->line.swap(this->pendingLine);
+        this->pendingLine.clear();
+      }
+
+      this->session->AddLine(this->line);
+      current = lineEnd + 1;
+    }
+  }
+
+  /**
+   * Feed
+   *
+   * @method
+   * @param {const std::string&} markdown
+   * @return {void}
+   */
+  void Feed(const std::string& markdown)
+  {
+    this->Feed(markdown.data(), markdown.size());
+  }
+
+  /**
+   * Finish
+   *
+   * Parses the last line, if it was not terminated by a newline, and closes
+   * all open blocks. Afterwards the `PushParser` can be used for the next
+   * document.
+   *
+   * @method
+   * @return {void}
+   */
+  void Finish()
+  {
+    if (!this->pendingLine.empty())
+    {
+      this->line.swap(this->pendingLine);
+      this->pendingLine.clear();
+      this->session->AddLine(this->line);
+    }
+
+    this->session->Finish();
+  }
+
+private:
+  std::unique_ptr<ParserSession> session;
+  std::string line;
+  std::string pendingLine;
+}; // class PushParser
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
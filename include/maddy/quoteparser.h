@@ -7,10 +7,9 @@
 // -----------------------------------------------------------------------------
 
 #include <functional>
-#include <regex>
 #include <string>
 
-#include "maddy/blockparser.h"
+#include "maddy/containerparser.h"
 
 // -----------------------------------------------------------------------------
 
@@ -23,7 +22,7 @@ namespace maddy {
  *
  * @class
  */
-class QuoteParser : public BlockParser
+class QuoteParser : public ContainerParser
 {
 public:
   /**
@@ -31,17 +30,18 @@ public:
    *
    * @method
    * @param {std::function<void(std::string&)>} parseLineCallback
-   * @param {std::function<std::shared_ptr<BlockParser>(const std::string&
-   * line)>} getBlockParserForLineCallback
+   * @param {std::function<BlockParser*(const std::string& line)>}
+   * getBlockParserForLineCallback
    */
   QuoteParser(
     std::function<void(std::string&)> parseLineCallback,
-    std::function<std::shared_ptr<BlockParser>(const std::string& line)>
+    std::function<BlockParser*(const std::string& line)>
       getBlockParserForLineCallback
   )
-    : BlockParser(parseLineCallback, getBlockParserForLineCallback)
+    : ContainerParser(parseLineCallback, getBlockParserForLineCallback)
     , isStarted(false)
     , isFinished(false)
+    , isFinishing(false)
   {}
 
   /**
@@ -55,20 +55,33 @@ public:
    */
   static bool IsStartingLine(const std::string& line)
   {
-    static std::regex re(R"(^\>.*)");
-    return std::regex_match(line, re);
+    return !line.empty() && line[0] == '>' && hasNoLineBreakFrom(line, 1);
   }
 
   /**
-   * AddLine
+   * IsFinished
    *
-   * Adding a line which has to be parsed.
+   * @method
+   * @return {bool}
+   */
+  bool IsFinished() const override { return this->isFinished; }
+
+  /**
+   * Reset
    *
    * @method
-   * @param {std::string&} line
    * @return {void}
    */
-  void AddLine(std::string& line) override
+  void Reset() override
+  {
+    ContainerParser::Reset();
+    this->isStarted = false;
+    this->isFinished = false;
+    this->isFinishing = false;
+  }
+
+protected:
+  void parseContainerLine(ContainerLine& line) override
   {
     if (!this->isStarted)
     {
@@ -76,38 +89,23 @@ public:
       this->isStarted = true;
     }
 
-    bool finish = false;
-    if (line.empty())
-    {
-      finish = true;
-    }
+    // an empty line ends the quote, if it has no open child block
+    this->isFinishing = line.IsEmpty();
 
-    this->parseBlock(line);
-
-    if (this->isInlineBlockAllowed() && !this->childParser)
-    {
-      this->childParser = this->getBlockParserForLine(line);
-    }
+    line.ErasePrefix("> ");
+    line.ErasePrefix(">");
 
-    if (this->childParser)
+    if (!line.IsEmpty())
     {
-      this->childParser->AddLine(line);
-
-      if (this->childParser->IsFinished())
-      {
-        this->result << this->childParser->GetResult().str();
-        this->childParser = nullptr;
-      }
-
-      return;
+      line.AppendSpace();
     }
+  }
 
-    if (this->isLineParserAllowed())
-    {
-      this->parseLine(line);
-    }
+  void addContainerLine(std::string& line) override
+  {
+    this->parseLine(line);
 
-    if (finish)
+    if (this->isFinishing)
     {
       this->result << "</blockquote>";
       this->isFinished = true;
@@ -116,35 +114,10 @@ public:
     this->result << line;
   }
 
-  /**
-   * IsFinished
-   *
-   * @method
-   * @return {bool}
-   */
-  bool IsFinished() const override { return this->isFinished; }
-
-protected:
-  bool isInlineBlockAllowed() const override { return true; }
-
-  bool isLineParserAllowed() const override { return true; }
-
-  void parseBlock(std::string& line) override
-  {
-    static std::regex lineRegexWithSpace(R"(^\> )");
-    line = std::regex_replace(line, lineRegexWithSpace, "");
-    static std::regex lineRegexWithoutSpace(R"(^\>)");
-    line = std::regex_replace(line, lineRegexWithoutSpace, "");
-
-    if (!line.empty())
-    {
-      line += " ";
-    }
-  }
-
 private:
   bool isStarted;
   bool isFinished;
+  bool isFinishing;
 }; // class QuoteParser
 
 // -----------------------------------------------------------------------------
@@ -0,0 +1,59 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+
+// The instruction set is chosen at compile time: `MADDY_SIMD_AVX2` (which
+// also defines `MADDY_SIMD_SSE2`) or `MADDY_SIMD_SSE2`. Without any of them
+// the scalar code is used. Define `MADDY_NO_SIMD` to always use it.
+#if !defined(MADDY_NO_SIMD)
+#if defined(__AVX2__)
+#define MADDY_SIMD_AVX2
+#define MADDY_SIMD_SSE2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || \
+  (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MADDY_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+namespace simd {
+
+/**
+ * CountTrailingZeros
+ *
+ * @param {uint32_t} mask must not be 0
+ * @return {uint32_t}
+ */
+inline uint32_t CountTrailingZeros(uint32_t mask)
+{
+#if defined(_MSC_VER)
+  unsigned long index;
+  _BitScanForward(&index, mask);
+  return static_cast<uint32_t>(index);
+#else
+  return static_cast<uint32_t>(__builtin_ctz(mask));
+#endif
+}
+
+} // namespace simd
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
@@ -0,0 +1,1107 @@
+/*
+ * This project is licensed under the MIT license. For more information see the
+ * LICENSE file.
+ */
+#pragma once
+
+// -----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "maddy/htmlescape.h"
+
+// -----------------------------------------------------------------------------
+
+namespace maddy {
+
+// -----------------------------------------------------------------------------
+
+/**
+ * SyntaxHighlighter
+ *
+ * Highlights the code of a fenced code block in the language of its info
+ * string. Every token becomes a `<span>` with one of the classes
+ * `hl-keyword`, `hl-type`, `hl-literal`, `hl-string`, `hl-number`,
+ * `hl-comment`, `hl-meta`, `hl-variable`, `hl-key`, `hl-heading`,
+ * `hl-addition`, `hl-deletion` and `hl-section`. The code is escaped like
+ * with `HtmlEscape::AppendText`, so without the spans it is the same text.
+ *
+ * Supported are C/C++, Python, shell, JSON, YAML, Markdown and diff. The
+ * languages are tables of keywords, comment and string delimiters, line
+ * prefixes and a few flags (see `getLanguages`), there is one lexer for all
+ * of them. A byte table per language tells which bytes can start a token,
+ * the runs in between are copied at once.
+ *
+ * Spans never cross lines. Block comments and strings over several lines
+ * are continued with the `State` of the block.
+ *
+ * ```
+ * const maddy::SyntaxHighlighter* highlighter =
+ *   maddy::SyntaxHighlighter::Find("cpp");
+ * maddy::SyntaxHighlighter::State state;
+ * highlighter->Highlight(line.data(), line.size(), state, html);
+ * ```
+ *
+ * @class
+ */
+class SyntaxHighlighter
+{
+public:
+  /**
+   * State
+   *
+   * What is still open at the end of a line.
+   */
+  struct State
+  {
+    State()
+      : mode(CODE_MODE)
+      , delimiter(0)
+    {}
+
+    uint8_t mode;
+    // the quote of a long string
+    char delimiter;
+  }; // struct State
+
+  /**
+   * Find
+   *
+   * @method
+   * @param {const std::string&} infoString of the code block, only the first
+   * word is the language, e.g. `cpp` or `python title="example"`
+   * @return {const SyntaxHighlighter*} nullptr for unknown languages
+   */
+  static const SyntaxHighlighter* Find(const std::string& infoString)
+  {
+    size_t begin = 0;
+
+    while (begin < infoString.size() &&
+           (infoString[begin] == ' ' || infoString[begin] == '\t'))
+    {
+      ++begin;
+    }
+
+    std::string name;
+
+    for (size_t i = begin; i < infoString.size(); ++i)
+    {
+      const char c = infoString[i];
+
+      if (c == ' ' || c == '\t' || c == '{' || c == ',')
+      {
+        break;
+      }
+
+      name += (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    if (name.empty())
+    {
+      return nullptr;
+    }
+
+    for (const SyntaxHighlighter& highlighter : getHighlighters())
+    {
+      if (containsWord(highlighter.language.names, name))
+      {
+        return &highlighter;
+      }
+    }
+
+    return nullptr;
+  }
+
+  /**
+   * Highlight
+   *
+   * @method
+   * @param {const char*} data of one line without the line break
+   * @param {size_t} size
+   * @param {State&} state of the code block, updated for the next line
+   * @param {std::string&} output the HTML is appended to
+   * @return {void}
+   */
+  void Highlight(
+    const char* data, size_t size, State& state, std::string& output
+  ) const
+  {
+    size_t pos = 0;
+
+    if (state.mode == BLOCK_COMMENT_MODE)
+    {
+      pos = this->appendBlockComment(data, size, 0, 0, state, output);
+    }
+    else if (state.mode == LONG_STRING_MODE)
+    {
+      pos = this->appendLongString(data, size, 0, 0, state, output);
+    }
+    else
+    {
+      const uint8_t tokenClass = this->getLinePrefixClass(data, size);
+
+      if (tokenClass != PLAIN_TOKEN)
+      {
+        appendToken(tokenClass, data, size, output);
+        return;
+      }
+
+      if (this->hasFlag(PREPROCESSOR_FLAG))
+      {
+        size_t indentation = 0;
+
+        while (indentation < size && isSpace(data[indentation]))
+        {
+          ++indentation;
+        }
+
+        if (indentation < size && data[indentation] == '#')
+        {
+          output.append(data, indentation);
+          appendToken(
+            META_TOKEN, data + indentation, size - indentation, output
+          );
+          return;
+        }
+      }
+
+      if (this->hasFlag(YAML_KEYS_FLAG))
+      {
+        pos = this->appendYamlKey(data, size, output);
+      }
+    }
+
+    while (pos < size)
+    {
+      const char c = data[pos];
+
+      switch (this->charClasses[static_cast<unsigned char>(c)])
+      {
+        case PLAIN_CHAR:
+        {
+          size_t end = pos + 1;
+
+          while (end < size && this->charClasses[static_cast<unsigned char>(
+                                 data[end]
+                               )] == PLAIN_CHAR)
+          {
+            ++end;
+          }
+
+          output.append(data + pos, end - pos);
+          pos = end;
+          break;
+        }
+        case ESCAPE_CHAR:
+          HtmlEscape::AppendText(output, data + pos, 1);
+          ++pos;
+          break;
+        case IDENTIFIER_CHAR:
+          pos = this->appendIdentifier(data, size, pos, output);
+          break;
+        case DIGIT_CHAR:
+          pos = appendNumber(data, size, pos, output);
+          break;
+        case QUOTE_CHAR:
+        case RAW_QUOTE_CHAR:
+          pos = this->appendString(data, size, pos, state, output);
+          break;
+        case COMMENT_CHAR:
+          pos = this->appendComment(data, size, pos, state, output);
+          break;
+        case VARIABLE_CHAR:
+          pos = appendVariable(data, size, pos, output);
+          break;
+        case DECORATOR_CHAR:
+          pos = appendDecorator(data, size, pos, output);
+          break;
+      }
+    }
+  }
+
+private:
+  enum Mode : uint8_t
+  {
+    CODE_MODE,
+    BLOCK_COMMENT_MODE,
+    LONG_STRING_MODE
+  };
+
+  enum TokenClass : uint8_t
+  {
+    PLAIN_TOKEN,
+    KEYWORD_TOKEN,
+    TYPE_TOKEN,
+    LITERAL_TOKEN,
+    STRING_TOKEN,
+    NUMBER_TOKEN,
+    COMMENT_TOKEN,
+    META_TOKEN,
+    VARIABLE_TOKEN,
+    KEY_TOKEN,
+    HEADING_TOKEN,
+    ADDITION_TOKEN,
+    DELETION_TOKEN,
+    SECTION_TOKEN
+  };
+
+  // what a byte can start
+  enum CharClass : uint8_t
+  {
+    PLAIN_CHAR,
+    ESCAPE_CHAR,
+    IDENTIFIER_CHAR,
+    DIGIT_CHAR,
+    QUOTE_CHAR,
+    RAW_QUOTE_CHAR,
+    COMMENT_CHAR,
+    VARIABLE_CHAR,
+    DECORATOR_CHAR
+  };
+
+  enum Flag : uint32_t
+  {
+    NUMBERS_FLAG = 0b1,
+    // `#` at the start of a line (after the indentation) starts a directive
+    PREPROCESSOR_FLAG = 0b10,
+    // `"""` and `'''` start strings over several lines
+    LONG_STRINGS_FLAG = 0b100,
+    // `$name`, `${name}` and `$1`
+    VARIABLES_FLAG = 0b1000,
+    // `@name`
+    DECORATORS_FLAG = 0b10000,
+    // a string followed by `:` is a key
+    STRING_KEYS_FLAG = 0b100000,
+    // `key:` at the start of a line or list item
+    YAML_KEYS_FLAG = 0b1000000,
+    // line comments only start at the start of a line or after a space
+    SPACED_COMMENTS_FLAG = 0b10000000,
+    // strings only start at the start of a line or after a separator
+    SPACED_QUOTES_FLAG = 0b100000000
+  };
+
+  enum : size_t
+  {
+    MAX_KEYWORD_SIZE = 32
+  };
+
+  struct LinePrefix
+  {
+    const char* prefix;
+    TokenClass tokenClass;
+  };
+
+  /**
+   * Language
+   *
+   * The word lists and names are separated by spaces, the line prefixes are
+   * checked in order and end with `nullptr`.
+   */
+  struct Language
+  {
+    const char* names;
+    const char* keywords;
+    const char* types;
+    const char* literals;
+    const char* lineComment;
+    const char* blockCommentBegin;
+    const char* blockCommentEnd;
+    // with backslash escapes
+    const char* quotes;
+    // without escapes
+    const char* rawQuotes;
+    const LinePrefix* linePrefixes;
+    uint32_t flags;
+  };
+
+  struct Keyword
+  {
+    const char* word;
+    size_t size;
+    TokenClass tokenClass;
+  };
+
+  const Language& language;
+  uint8_t charClasses[256];
+  // open addressing, the size is a power of 2
+  std::vector<Keyword> keywords;
+  size_t keywordCount;
+
+  explicit SyntaxHighlighter(const Language& language)
+    : language(language)
+    , keywordCount(0)
+  {
+    std::memset(this->charClasses, PLAIN_CHAR, sizeof(this->charClasses));
+    this->charClasses[static_cast<unsigned char>('&')] = ESCAPE_CHAR;
+    this->charClasses[static_cast<unsigned char>('<')] = ESCAPE_CHAR;
+    this->charClasses[static_cast<unsigned char>('>')] = ESCAPE_CHAR;
+
+    this->addKeywords(language.keywords, KEYWORD_TOKEN);
+    this->addKeywords(language.types, TYPE_TOKEN);
+    this->addKeywords(language.literals, LITERAL_TOKEN);
+
+    if (this->keywordCount > 0)
+    {
+      for (int c = 0; c < 256; ++c)
+      {
+        if (isIdentifierStart(static_cast<char>(c)))
+        {
+          this->charClasses[c] = IDENTIFIER_CHAR;
+        }
+      }
+    }
+
+    if (this->hasFlag(NUMBERS_FLAG))
+    {
+      for (char c = '0'; c <= '9'; ++c)
+      {
+        this->charClasses[static_cast<unsigned char>(c)] = DIGIT_CHAR;
+      }
+    }
+
+    this->setCharClass(language.quotes, QUOTE_CHAR);
+    this->setCharClass(language.rawQuotes, RAW_QUOTE_CHAR);
+
+    if (language.lineComment)
+    {
+      this->charClasses[static_cast<unsigned char>(language.lineComment[0])] =
+        COMMENT_CHAR;
+    }
+
+    if (language.blockCommentBegin)
+    {
+      this->charClasses[static_cast<unsigned char>(
+        language.blockCommentBegin[0]
+      )] = COMMENT_CHAR;
+    }
+
+    if (this->hasFlag(VARIABLES_FLAG))
+    {
+      this->charClasses[static_cast<unsigned char>('$')] = VARIABLE_CHAR;
+    }
+
+    if (this->hasFlag(DECORATORS_FLAG))
+    {
+      this->charClasses[static_cast<unsigned char>('@')] = DECORATOR_CHAR;
+    }
+  }
+
+  static const std::vector<SyntaxHighlighter>& getHighlighters()
+  {
+    static const std::vector<SyntaxHighlighter> highlighters = []()
+    {
+      std::vector<SyntaxHighlighter> result;
+      size_t count = 0;
+      const Language* languages = getLanguages(count);
+
+      for (size_t i = 0; i < count; ++i)
+      {
+        result.push_back(SyntaxHighlighter(languages[i]));
+      }
+
+      return result;
+    }();
+
+    return highlighters;
+  }
+
+  static const Language* getLanguages(size_t& count)
+  {
+    static const LinePrefix shellPrefixes[] = {
+      {"#!", META_TOKEN}, {nullptr, PLAIN_TOKEN}
+    };
+    static const LinePrefix yamlPrefixes[] = {
+      {"---", META_TOKEN}, {"...", META_TOKEN}, {nullptr, PLAIN_TOKEN}
+    };
+    static const LinePrefix markdownPrefixes[] = {
+      {"```", META_TOKEN},
+      {"~~~", META_TOKEN},
+      {"#", HEADING_TOKEN},
+      {">", COMMENT_TOKEN},
+      {nullptr, PLAIN_TOKEN}
+    };
+    static const LinePrefix diffPrefixes[] = {
+      {"diff ", META_TOKEN},
+      {"index ", META_TOKEN},
+      {"+++", META_TOKEN},
+      {"---", META_TOKEN},
+      {"@@", SECTION_TOKEN},
+      {"+", ADDITION_TOKEN},
+      {"-", DELETION_TOKEN},
+      {">", ADDITION_TOKEN},
+      {"<", DELETION_TOKEN},
+      {nullptr, PLAIN_TOKEN}
+    };
+    static const LinePrefix noPrefixes[] = {{nullptr, PLAIN_TOKEN}};
+
+    // clang-format off
+    static const Language languages[] = {
+      {
+        "c cpp c++ cc cxx h hh hpp hxx",
+        "alignas alignof asm auto break case catch class const consteval "
+        "constexpr constinit const_cast continue co_await co_return "
+        "co_yield decltype default delete do dynamic_cast else enum "
+        "explicit export extern final for friend goto if inline mutable "
+        "namespace new noexcept operator override private protected public "
+        "register reinterpret_cast requires return sizeof static "
+        "static_assert static_cast struct switch template this "
+        "thread_local throw try typedef typeid typename union using "
+        "virtual volatile while",
+        "bool char char8_t char16_t char32_t double float int long short "
+        "signed unsigned void wchar_t size_t ptrdiff_t int8_t int16_t "
+        "int32_t int64_t uint8_t uint16_t uint32_t uint64_t intptr_t "
+        "uintptr_t",
+        "true false nullptr NULL",
+        "//", "/*", "*/", "\"'", nullptr,
+        noPrefixes,
+        NUMBERS_FLAG | PREPROCESSOR_FLAG
+      },
+      {
+        "python py python3",
+        "and as assert async await break case class continue def del elif "
+        "else except finally for from global if import in is lambda match "
+        "nonlocal not or pass raise return try while with yield",
+        "bool bytearray bytes complex dict float frozenset int list object "
+        "set str tuple type",
+        "True False None",
+        "#", nullptr, nullptr, "\"'", nullptr,
+        noPrefixes,
+        NUMBERS_FLAG | LONG_STRINGS_FLAG | DECORATORS_FLAG
+      },
+      {
+        "sh bash shell zsh ksh",
+        "if then else elif fi case esac for select while until do done in "
+        "function time return local export readonly declare break "
+        "continue exit",
+        "alias cd echo eval exec printf read set shift source test trap "
+        "unset",
+        "true false",
+        "#", nullptr, nullptr, "\"`", "'",
+        shellPrefixes,
+        NUMBERS_FLAG | VARIABLES_FLAG | SPACED_COMMENTS_FLAG
+      },
+      {
+        "json jsonc json5",
+        "",
+        "",
+        "true false null",
+        "//", "/*", "*/", "\"", nullptr,
+        noPrefixes,
+        NUMBERS_FLAG | STRING_KEYS_FLAG
+      },
+      {
+        "yaml yml",
+        "",
+        "",
+        "true false null True False Null TRUE FALSE NULL",
+        "#", nullptr, nullptr, "\"", "'",
+        yamlPrefixes,
+        NUMBERS_FLAG | STRING_KEYS_FLAG | YAML_KEYS_FLAG |
+          SPACED_COMMENTS_FLAG | SPACED_QUOTES_FLAG
+      },
+      {
+        "markdown md mkd",
+        "",
+        "",
+        "",
+        nullptr, nullptr, nullptr, nullptr, "`",
+        markdownPrefixes,
+        0
+      },
+      {
+        "diff patch udiff",
+        "",
+        "",
+        "",
+        nullptr, nullptr, nullptr, nullptr, nullptr,
+        diffPrefixes,
+        0
+      }
+    };
+    // clang-format on
+
+    count = sizeof(languages) / sizeof(languages[0]);
+    return languages;
+  }
+
+  struct Tag
+  {
+    const char* text;
+    size_t size;
+  };
+
+  template <size_t Size>
+  static Tag makeTag(const char (&text)[Size])
+  {
+    return Tag{text, Size - 1};
+  }
+
+  static void appendOpeningTag(uint8_t tokenClass, std::string& output)
+  {
+    static const Tag tags[] = {
+      makeTag(""),
+      makeTag("<span class=\"hl-keyword\">"),
+      makeTag("<span class=\"hl-type\">"),
+      makeTag("<span class=\"hl-literal\">"),
+      makeTag("<span class=\"hl-string\">"),
+      makeTag("<span class=\"hl-number\">"),
+      makeTag("<span class=\"hl-comment\">"),
+      makeTag("<span class=\"hl-meta\">"),
+      makeTag("<span class=\"hl-variable\">"),
+      makeTag("<span class=\"hl-key\">"),
+      makeTag("<span class=\"hl-heading\">"),
+      makeTag("<span class=\"hl-addition\">"),
+      makeTag("<span class=\"hl-deletion\">"),
+      makeTag("<span class=\"hl-section\">")
+    };
+
+    output.append(tags[tokenClass].text, tags[tokenClass].size);
+  }
+
+  // for tokens without `&`, `<` and `>`
+  static void appendPlainToken(
+    uint8_t tokenClass, const char* data, size_t size, std::string& output
+  )
+  {
+    appendOpeningTag(tokenClass, output);
+    output.append(data, size);
+    output.append("</span>", 7);
+  }
+
+  static bool containsWord(const char* words, const std::string& word)
+  {
+    const char* current = words;
+
+    while (*current)
+    {
+      const char* end = current;
+
+      while (*end && *end != ' ')
+      {
+        ++end;
+      }
+
+      if (static_cast<size_t>(end - current) == word.size() &&
+          word.compare(0, word.size(), current, word.size()) == 0)
+      {
+        return true;
+      }
+
+      current = *end ? end + 1 : end;
+    }
+
+    return false;
+  }
+
+  static bool isSpace(char c) { return c == ' ' || c == '\t'; }
+
+  static bool isOneOf(char c, const char* chars)
+  {
+    return c != '\0' && std::strchr(chars, c) != nullptr;
+  }
+
+  static bool isIdentifierStart(char c)
+  {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+  }
+
+  static bool isIdentifierPart(char c)
+  {
+    return isIdentifierStart(c) || (c >= '0' && c <= '9');
+  }
+
+  static uint32_t hash(const char* data, size_t size)
+  {
+    uint32_t result = 2166136261u;
+
+    for (size_t i = 0; i < size; ++i)
+    {
+      result = (result ^ static_cast<unsigned char>(data[i])) * 16777619u;
+    }
+
+    return result;
+  }
+
+  static void appendToken(
+    uint8_t tokenClass, const char* data, size_t size, std::string& output
+  )
+  {
+    appendOpeningTag(tokenClass, output);
+    HtmlEscape::AppendText(output, data, size);
+    output.append("</span>", 7);
+  }
+
+  // finds `token` from `pos` on, `std::string::npos` if it is not there
+  static size_t find(
+    const char* data, size_t size, size_t pos, const char* token
+  )
+  {
+    const size_t tokenSize = std::strlen(token);
+
+    while (pos + tokenSize <= size)
+    {
+      const char* found = static_cast<const char*>(
+        std::memchr(data + pos, token[0], size - pos - tokenSize + 1)
+      );
+
+      if (!found)
+      {
+        return std::string::npos;
+      }
+
+      pos = static_cast<size_t>(found - data);
+
+      if (std::memcmp(found, token, tokenSize) == 0)
+      {
+        return pos;
+      }
+
+      ++pos;
+    }
+
+    return std::string::npos;
+  }
+
+  static bool startsWith(
+    const char* data, size_t size, size_t pos, const char* token
+  )
+  {
+    const size_t tokenSize = std::strlen(token);
+
+    return size - pos >= tokenSize &&
+           std::memcmp(data + pos, token, tokenSize) == 0;
+  }
+
+  bool hasFlag(Flag flag) const { return (this->language.flags & flag) != 0; }
+
+  void setCharClass(const char* chars, CharClass charClass)
+  {
+    for (const char* c = chars; c && *c; ++c)
+    {
+      this->charClasses[static_cast<unsigned char>(*c)] = charClass;
+    }
+  }
+
+  void addKeywords(const char* words, TokenClass tokenClass)
+  {
+    for (const char* current = words; *current;)
+    {
+      const char* end = current;
+
+      while (*end && *end != ' ')
+      {
+        ++end;
+      }
+
+      const size_t size = static_cast<size_t>(end - current);
+
+      if (this->keywords.size() < 2 * (this->keywordCount + 1))
+      {
+        this->growKeywords();
+      }
+
+      const size_t mask = this->keywords.size() - 1;
+      size_t slot = hash(current, size) & mask;
+
+      while (this->keywords[slot].word)
+      {
+        slot = (slot + 1) & mask;
+      }
+
+      this->keywords[slot] = {current, size, tokenClass};
+      ++this->keywordCount;
+      current = *end ? end + 1 : end;
+    }
+  }
+
+  void growKeywords()
+  {
+    std::vector<Keyword> old;
+    old.swap(this->keywords);
+    this->keywords.assign(
+      old.empty() ? 64 : 2 * old.size(), Keyword{nullptr, 0, PLAIN_TOKEN}
+    );
+    const size_t mask = this->keywords.size() - 1;
+
+    for (const Keyword& keyword : old)
+    {
+      if (keyword.word)
+      {
+        size_t slot = hash(keyword.word, keyword.size) & mask;
+
+        while (this->keywords[slot].word)
+        {
+          slot = (slot + 1) & mask;
+        }
+
+        this->keywords[slot] = keyword;
+      }
+    }
+  }
+
+  TokenClass getKeywordClass(const char* data, size_t size) const
+  {
+    if (size > MAX_KEYWORD_SIZE)
+    {
+      return PLAIN_TOKEN;
+    }
+
+    const size_t mask = this->keywords.size() - 1;
+
+    for (size_t slot = hash(data, size) & mask; this->keywords[slot].word;
+         slot = (slot + 1) & mask)
+    {
+      const Keyword& keyword = this->keywords[slot];
+
+      if (keyword.size == size && std::memcmp(keyword.word, data, size) == 0)
+      {
+        return keyword.tokenClass;
+      }
+    }
+
+    return PLAIN_TOKEN;
+  }
+
+  uint8_t getLinePrefixClass(const char* data, size_t size) const
+  {
+    for (const LinePrefix* prefix = this->language.linePrefixes;
+         prefix->prefix;
+         ++prefix)
+    {
+      if (startsWith(data, size, 0, prefix->prefix))
+      {
+        return prefix->tokenClass;
+      }
+    }
+
+    return PLAIN_TOKEN;
+  }
+
+  size_t appendIdentifier(
+    const char* data, size_t size, size_t pos, std::string& output
+  ) const
+  {
+    size_t end = pos + 1;
+
+    while (end < size && isIdentifierPart(data[end]))
+    {
+      ++end;
+    }
+
+    const TokenClass tokenClass = this->getKeywordClass(data + pos, end - pos);
+
+    if (tokenClass == PLAIN_TOKEN)
+    {
+      output.append(data + pos, end - pos);
+    }
+    else
+    {
+      appendPlainToken(tokenClass, data + pos, end - pos, output);
+    }
+
+    return end;
+  }
+
+  // `0x1F`, `1.5e-3`, `10ul`
+  static size_t appendNumber(
+    const char* data, size_t size, size_t pos, std::string& output
+  )
+  {
+    const bool isHex = data[pos] == '0' && pos + 1 < size &&
+                       (data[pos + 1] == 'x' || data[pos + 1] == 'X');
+    size_t end = pos + 1;
+
+    while (end < size)
+    {
+      const char c = data[end];
+      const char previous = data[end - 1];
+
+      if (isIdentifierPart(c) || c == '.' ||
+          ((c == '+' || c == '-') && !isHex &&
+           (previous == 'e' || previous == 'E')))
+      {
+        ++end;
+      }
+      else
+      {
+        break;
+      }
+    }
+
+    appendPlainToken(NUMBER_TOKEN, data + pos, end - pos, output);
+
+    return end;
+  }
+
+  size_t appendString(
+    const char* data,
+    size_t size,
+    size_t pos,
+    State& state,
+    std::string& output
+  ) const
+  {
+    const char quote = data[pos];
+
+    if (this->hasFlag(SPACED_QUOTES_FLAG) && pos > 0 &&
+        !isOneOf(data[pos - 1], " \t[{,:"))
+    {
+      output += quote;
+      return pos + 1;
+    }
+
+    if (this->hasFlag(LONG_STRINGS_FLAG) && size - pos >= 3 &&
+        data[pos + 1] == quote && data[pos + 2] == quote)
+    {
+      state.mode = LONG_STRING_MODE;
+      state.delimiter = quote;
+
+      return this->appendLongString(data, size, pos, pos + 3, state, output);
+    }
+
+    const bool isRaw =
+      this->charClasses[static_cast<unsigned char>(quote)] == RAW_QUOTE_CHAR;
+    size_t end = pos + 1;
+
+    while (end < size && data[end] != quote)
+    {
+      end += (!isRaw && data[end] == '\\') ? 2 : 1;
+    }
+
+    end = end < size ? end + 1 : size;
+    uint8_t tokenClass = STRING_TOKEN;
+
+    if (this->hasFlag(STRING_KEYS_FLAG))
+    {
+      size_t colon = end;
+
+      while (colon < size && isSpace(data[colon]))
+      {
+        ++colon;
+      }
+
+      if (colon < size && data[colon] == ':')
+      {
+        tokenClass = KEY_TOKEN;
+      }
+    }
+
+    appendToken(tokenClass, data + pos, end - pos, output);
+
+    return end;
+  }
+
+  // the long string from `begin` on, the closing quotes are searched from
+  // `pos` on
+  size_t appendLongString(
+    const char* data,
+    size_t size,
+    size_t begin,
+    size_t pos,
+    State& state,
+    std::string& output
+  ) const
+  {
+    const char quote = state.delimiter;
+    size_t end = pos;
+
+    while (end < size)
+    {
+      if (data[end] == '\\')
+      {
+        end += 2;
+      }
+      else if (data[end] == quote && size - end >= 3 &&
+               data[end + 1] == quote && data[end + 2] == quote)
+      {
+        end += 3;
+        state.mode = CODE_MODE;
+        break;
+      }
+      else
+      {
+        ++end;
+      }
+    }
+
+    end = end < size ? end : size;
+    appendToken(STRING_TOKEN, data + begin, end - begin, output);
+
+    return end;
+  }
+
+  size_t appendComment(
+    const char* data,
+    size_t size,
+    size_t pos,
+    State& state,
+    std::string& output
+  ) const
+  {
+    const char* lineComment = this->language.lineComment;
+
+    if (lineComment && startsWith(data, size, pos, lineComment) &&
+        (!this->hasFlag(SPACED_COMMENTS_FLAG) || pos == 0 ||
+         isSpace(data[pos - 1])))
+    {
+      appendToken(COMMENT_TOKEN, data + pos, size - pos, output);
+      return size;
+    }
+
+    const char* blockCommentBegin = this->language.blockCommentBegin;
+
+    if (blockCommentBegin && startsWith(data, size, pos, blockCommentBegin))
+    {
+      state.mode = BLOCK_COMMENT_MODE;
+
+      return this->appendBlockComment(
+        data, size, pos, pos + std::strlen(blockCommentBegin), state, output
+      );
+    }
+
+    output += data[pos];
+    return pos + 1;
+  }
+
+  // the block comment from `begin` on, the end is searched from `pos` on
+  size_t appendBlockComment(
+    const char* data,
+    size_t size,
+    size_t begin,
+    size_t pos,
+    State& state,
+    std::string& output
+  ) const
+  {
+    const char* blockCommentEnd = this->language.blockCommentEnd;
+    size_t end = find(data, size, pos, blockCommentEnd);
+
+    if (end == std::string::npos)
+    {
+      end = size;
+    }
+    else
+    {
+      end += std::strlen(blockCommentEnd);
+      state.mode = CODE_MODE;
+    }
+
+    appendToken(COMMENT_TOKEN, data + begin, end - begin, output);
+
+    return end;
+  }
+
+  static size_t appendVariable(
+    const char* data, size_t size, size_t pos, std::string& output
+  )
+  {
+    size_t end = pos + 1;
+
+    if (end < size && data[end] == '{')
+    {
+      const char* brace = static_cast<const char*>(
+        std::memchr(data + end, '}', size - end)
+      );
+      end = brace ? static_cast<size_t>(brace - data) + 1 : size;
+    }
+    else if (end < size && isIdentifierPart(data[end]))
+    {
+      while (end < size && isIdentifierPart(data[end]))
+      {
+        ++end;
+      }
+    }
+    else if (end < size && isOneOf(data[end], "@*#?$!-"))
+    {
+      ++end;
+    }
+    else
+    {
+      output += '$';
+      return end;
+    }
+
+    appendToken(VARIABLE_TOKEN, data + pos, end - pos, output);
+
+    return end;
+  }
+
+  static size_t appendDecorator(
+    const char* data, size_t size, size_t pos, std::string& output
+  )
+  {
+    size_t end = pos + 1;
+
+    while (end < size && (isIdentifierPart(data[end]) || data[end] == '.'))
+    {
+      ++end;
+    }
+
+    if (end == pos + 1)
+    {
+      output += '@';
+      return end;
+    }
+
+    appendPlainToken(META_TOKEN, data + pos, end - pos, output);
+
+    return end;
+  }
+
+  // `key:` or `- key:` at the start of a line, returns the position after
+  // the key
+  size_t appendYamlKey(const char* data, size_t size, std::string& output)
+      const
+  {
+    size_t begin = 0;
+
+    for (;;)
+    {
+      while (begin < size && isSpace(data[begin]))
+      {
+        ++begin;
+      }
+
+      if (begin < size && data[begin] == '-' &&
+          (begin + 1 == size || isSpace(data[begin + 1])))
+      {
+        ++begin;
+        continue;
+      }
+
+      break;
+    }
+
+    output.append(data, begin);
+
+    if (begin == size || isOneOf(data[begin], "\"'#{[&*!|>%@`"))
+    {
+      return begin;
+    }
+
+    for (size_t colon = begin; colon < size; ++colon)
+    {
+      if (data[colon] == '#' && colon > begin && isSpace(data[colon - 1]))
+      {
+        break;
+      }
+
+      if (data[colon] == ':' &&
+          (colon + 1 == size || isSpace(data[colon + 1])))
+      {
+        appendToken(KEY_TOKEN, data + begin, colon - begin, output);
+        return colon;
+      }
+    }
+
+    return begin;
+  }
+}; // class SyntaxHighlighter
+
+// -----------------------------------------------------------------------------
+
+} // namespace maddy
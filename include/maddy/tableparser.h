@@ -7,8 +7,8 @@
 // -----------------------------------------------------------------------------
 
 #include <functional>
-#include <regex>
 #include <string>
+#include <vector>
 
 #include "maddy/blockparser.h"
 
@@ -33,12 +33,12 @@ public:
    *
    * @method
    * @param {std::function<void(std::string&)>} parseLineCallback
-   * @param {std::function<std::shared_ptr<BlockParser>(const std::string&
-   * line)>} getBlockParserForLineCallback
+   * @param {std::function<BlockParser*(const std::string& line)>}
+   * getBlockParserForLineCallback
    */
   TableParser(
     std::function<void(std::string&)> parseLineCallback,
-    std::function<std::shared_ptr<BlockParser>(const std::string& line)>
+    std::function<BlockParser*(const std::string& line)>
       getBlockParserForLineCallback
   )
     : BlockParser(parseLineCallback, getBlockParserForLineCallback)
@@ -59,7 +59,7 @@ public:
    */
   static bool IsStartingLine(const std::string& line)
   {
-    static std::string matchString("|table>");
+    static const std::string matchString("|table>");
     return line == matchString;
   }
 
@@ -91,7 +91,7 @@ public:
 
       if (line == "|<table")
       {
-        static std::string emptyLine = "";
+        std::string emptyLine = "";
         this->parseBlock(emptyLine);
         this->isFinished = true;
         return;
@@ -103,13 +103,23 @@ public:
       }
       this->table[this->currentBlock].push_back(std::vector<std::string>());
 
-      std::string segment;
-      std::stringstream streamToSplit(line);
+      // split like `std::getline` with `|`: no cell behind a trailing `|`
+      std::vector<std::string>& cells =
+        this->table[this->currentBlock][this->currentRow];
+      size_t cellBegin = 0;
 
-      while (std::getline(streamToSplit, segment, '|'))
+      while (cellBegin < line.size())
       {
-        this->parseLine(segment);
-        this->table[this->currentBlock][this->currentRow].push_back(segment);
+        size_t cellEnd = line.find('|', cellBegin);
+
+        if (cellEnd == std::string::npos)
+        {
+          cellEnd = line.size();
+        }
+
+        cells.emplace_back(line, cellBegin, cellEnd - cellBegin);
+        this->parseLine(cells.back());
+        cellBegin = cellEnd + 1;
       }
 
       ++this->currentRow;
@@ -126,6 +136,22 @@ public:
    */
   bool IsFinished() const override { return this->isFinished; }
 
+  /**
+   * Reset
+   *
+   * @method
+   * @return {void}
+   */
+  void Reset() override
+  {
+    BlockParser::Reset();
+    this->isStarted = false;
+    this->isFinished = false;
+    this->currentBlock = 0;
+    this->currentRow = 0;
+    this->table.clear();
+  }
+
 protected:
   bool isInlineBlockAllowed() const override { return false; }
 
@@ -7,10 +7,9 @@
 // -----------------------------------------------------------------------------
 
 #include <functional>
-#include <regex>
 #include <string>
 
-#include "maddy/blockparser.h"
+#include "maddy/containerparser.h"
 
 // -----------------------------------------------------------------------------
 
@@ -23,7 +22,7 @@ namespace maddy {
  *
  * @class
  */
-class UnorderedListParser : public BlockParser
+class UnorderedListParser : public ContainerParser
 {
 public:
   /**
@@ -31,15 +30,15 @@ public:
    *
    * @method
    * @param {std::function<void(std::string&)>} parseLineCallback
-   * @param {std::function<std::shared_ptr<BlockParser>(const std::string&
-   * line)>} getBlockParserForLineCallback
+   * @param {std::function<BlockParser*(const std::string& line)>}
+   * getBlockParserForLineCallback
    */
   UnorderedListParser(
     std::function<void(std::string&)> parseLineCallback,
-    std::function<std::shared_ptr<BlockParser>(const std::string& line)>
+    std::function<BlockParser*(const std::string& line)>
       getBlockParserForLineCallback
   )
-    : BlockParser(parseLineCallback, getBlockParserForLineCallback)
+    : ContainerParser(parseLineCallback, getBlockParserForLineCallback)
     , isStarted(false)
     , isFinished(false)
   {}
@@ -55,8 +54,9 @@ public:
    */
   static bool IsStartingLine(const std::string& line)
   {
-    static std::regex re("^[+*-] .*");
-    return std::regex_match(line, re);
+    return line.size() >= 2 &&
+           (line[0] == '+' || line[0] == '*' || line[0] == '-') &&
+           line[1] == ' ' && hasNoLineBreakFrom(line, 2);
   }
 
   /**
@@ -67,44 +67,61 @@ public:
    */
   bool IsFinished() const override { return this->isFinished; }
 
-protected:
-  bool isInlineBlockAllowed() const override { return true; }
+  /**
+   * Reset
+   *
+   * @method
+   * @return {void}
+   */
+  void Reset() override
+  {
+    ContainerParser::Reset();
+    this->isStarted = false;
+    this->isFinished = false;
+  }
 
-  bool isLineParserAllowed() const override { return true; }
+protected:
+  size_t getChildIndentation() const override { return 2; }
 
-  void parseBlock(std::string& line) override
+  void parseContainerLine(ContainerLine& line) override
   {
-    bool isStartOfNewListItem = IsStartingLine(line);
-    uint32_t indentation = getIndentationWidth(line);
-
-    static std::regex lineRegex("^([+*-] )");
-    line = std::regex_replace(line, lineRegex, "");
+    const bool isMarked = line.GetSize() >= 2 &&
+                          (line.At(0) == '+' || line.At(0) == '*' ||
+                           line.At(0) == '-') &&
+                          line.At(1) == ' ';
+    const bool isStartOfNewListItem = isMarked && line.HasNoLineBreakFrom(2);
+    const bool isNested = line.IsIndented(2);
+
+    if (isMarked)
+    {
+      line.Erase(2);
+    }
 
     if (!this->isStarted)
     {
-      line = "<ul><li>" + line;
+      line.Insert("<ul><li>");
       this->isStarted = true;
       return;
     }
 
-    if (indentation >= 2)
+    if (isNested)
     {
-      line = line.substr(2);
+      line.Erase(2);
       return;
     }
 
-    if (line.empty() || line.find("</li><li>") != std::string::npos ||
-        line.find("</li></ol>") != std::string::npos ||
-        line.find("</li></ul>") != std::string::npos)
+    // the closing tags of a parent item close this list as well
+    if (line.IsEmpty() || line.IsItemClosed() ||
+        line.ContainsTag("</li>", {"<li>", "</ol>", "</ul>"}))
     {
-      line = "</li></ul>" + line;
+      line.CloseItem("</li></ul>");
       this->isFinished = true;
       return;
     }
 
     if (isStartOfNewListItem)
     {
-      line = "</li><li>" + line;
+      line.CloseItem("</li><li>");
     }
   }
 
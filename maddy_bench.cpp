@@ -0,0 +1,813 @@
+// Throughput benchmark for the maddy parser.
+//
+// Runs maddy::Parser over a reproducible synthetic corpus (fixed seeds) and
+// over real Markdown files, once per ParserConfig preset, and reports MB/s,
+// lines/s and ns/line. The results are also written as JSON, so that runs
+// before and after a change can be compared by a script. The outputs of the
+// shared-parser, parallel-parse and tree runs are compared with a single
+// threaded Parse, the benchmark exits with 1 on any difference.
+//
+//   maddy_bench [--quick] [--size MiB] [--repeat N] [--threads N]
+//               [--filter TEXT] [--json FILE] [file.md ...]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "maddy/blockclassifier.h"
+#include "maddy/documentrenderer.h"
+#include "maddy/inputnormalizer.h"
+#include "maddy/parser.h"
+#include "maddy/parserpool.h"
+
+#ifndef MADDY_BENCH_SOURCE_DIR
+#define MADDY_BENCH_SOURCE_DIR "."
+#endif
+
+namespace {
+
+const size_t MiB = 1024 * 1024;
+
+struct Options {
+    size_t corpusSize = 8 * MiB;
+    size_t repeat = 5;
+    size_t threads = 0;
+    bool quick = false;
+    std::string filter;
+    std::string jsonPath = "maddy_bench.json";
+    std::vector<std::string> files;
+};
+
+struct Preset {
+    std::string name;
+    std::shared_ptr<maddy::ParserConfig> config;
+};
+
+struct Result {
+    std::string scenario;
+    std::string preset;
+    size_t threads;
+    size_t bytes;
+    size_t lines;
+    size_t outputBytes;
+    size_t runs;
+    double seconds; // best run
+};
+
+// ---------------------------------------------------------------------------
+// Corpus generators, every one starts from its own fixed seed
+
+const char* const WORDS[] = {
+    "the", "viewer", "renders", "markdown", "into", "html", "with", "a",
+    "parser", "that", "reads", "every", "line", "once", "and", "writes",
+    "blocks", "as", "soon", "they", "are", "finished", "fast", "lists",
+    "tables", "code", "quotes", "headlines", "links", "images", "of", "on",
+};
+
+class TextGenerator {
+public:
+    explicit TextGenerator(uint32_t seed) : rng(seed) {}
+
+    size_t Pick(size_t count) { return rng() % count; }
+
+    bool Chance(size_t percent) { return Pick(100) < percent; }
+
+    const char* Word() { return WORDS[Pick(sizeof(WORDS) / sizeof(WORDS[0]))]; }
+
+    // a line of words with some inline markup
+    void AppendSentence(std::string& out, size_t words, size_t markupPercent) {
+        for (size_t i = 0; i < words; ++i) {
+            if (i > 0) {
+                out += ' ';
+            }
+
+            if (!Chance(markupPercent)) {
+                out += Word();
+                continue;
+            }
+
+            switch (Pick(6)) {
+            case 0: out += "**"; out += Word(); out += "**"; break;
+            case 1: out += '*'; out += Word(); out += '*'; break;
+            case 2: out += '_'; out += Word(); out += '_'; break;
+            case 3: out += '`'; out += Word(); out += "()`"; break;
+            case 4:
+                out += '['; out += Word(); out += "](https://example.com/";
+                out += Word(); out += ')';
+                break;
+            default: out += "~~"; out += Word(); out += "~~"; break;
+            }
+        }
+    }
+
+private:
+    std::mt19937 rng;
+};
+
+std::string generateProse(size_t size) {
+    TextGenerator gen(1);
+    std::string md;
+
+    while (md.size() < size) {
+        if (gen.Chance(15)) {
+            md += std::string(1 + gen.Pick(3), '#') + ' ';
+            gen.AppendSentence(md, 2 + gen.Pick(5), 0);
+            md += "\n\n";
+        }
+
+        const bool isQuote = gen.Chance(10);
+
+        for (size_t line = 3 + gen.Pick(4); line > 0; --line) {
+            md += isQuote ? "> " : "";
+            gen.AppendSentence(md, 8 + gen.Pick(8), 6);
+            md += '\n';
+        }
+
+        md += gen.Chance(5) ? "\n---\n\n" : "\n";
+    }
+
+    return md;
+}
+
+std::string generateDeepLists(size_t size) {
+    TextGenerator gen(2);
+    std::string md;
+
+    while (md.size() < size) {
+        if (gen.Chance(20)) {
+            // checklists only nest checklists
+            for (size_t item = 5 + gen.Pick(20); item > 0; --item) {
+                md += std::string(2 * gen.Pick(4), ' ');
+                md += gen.Chance(50) ? "- [x] " : "- [ ] ";
+                gen.AppendSentence(md, 3 + gen.Pick(6), 5);
+                md += '\n';
+            }
+        } else {
+            // a random walk down to 20 levels and back
+            size_t depth = 0;
+
+            for (size_t item = 20 + gen.Pick(60); item > 0; --item) {
+                md += std::string(2 * depth, ' ');
+                md += gen.Chance(30) ? "1. " : (gen.Chance(50) ? "- " : "* ");
+                gen.AppendSentence(md, 3 + gen.Pick(6), 5);
+                md += '\n';
+
+                if (depth < 19 && gen.Chance(60)) {
+                    ++depth;
+                } else if (depth > 0 && gen.Chance(70)) {
+                    depth -= 1 + gen.Pick(depth);
+                }
+            }
+        }
+
+        md += '\n';
+    }
+
+    return md;
+}
+
+// the same items as a flat list or as an outline, which goes down to
+// `maxDepth` levels and has some siblings on every level
+std::string generateListOutline(size_t size, size_t maxDepth) {
+    TextGenerator text(7);
+    TextGenerator walk(8);
+    std::string md;
+    size_t depth = 0;
+
+    while (md.size() < size) {
+        md += std::string(2 * depth, ' ');
+        md += "- ";
+        text.AppendSentence(md, 3 + text.Pick(6), 5);
+        md += '\n';
+
+        if (depth + 1 < maxDepth && walk.Chance(45)) {
+            ++depth;
+        } else if (depth > 0 && walk.Chance(45)) {
+            --depth;
+        }
+    }
+
+    return md;
+}
+
+std::string generateTables(size_t size) {
+    TextGenerator gen(3);
+    std::string md;
+    const size_t columns = 8;
+
+    while (md.size() < size) {
+        if (gen.Chance(25)) {
+            // the original maddy table format
+            md += "|table>\n";
+
+            for (size_t column = 0; column < columns; ++column) {
+                md += column > 0 ? " | " : "";
+                md += gen.Word();
+            }
+
+            md += "\n- | - | - | - | - | - | - | -\n";
+
+            for (size_t row = 500 + gen.Pick(500); row > 0; --row) {
+                for (size_t column = 0; column < columns; ++column) {
+                    md += column > 0 ? " | " : "";
+                    gen.AppendSentence(md, 1 + gen.Pick(3), 10);
+                }
+
+                md += '\n';
+            }
+
+            md += "|<table\n\n";
+            continue;
+        }
+
+        md += '|';
+
+        for (size_t column = 0; column < columns; ++column) {
+            md += ' ';
+            md += gen.Word();
+            md += " |";
+        }
+
+        md += "\n|:---|---:|:---:|---|---|---|---|---|\n";
+
+        for (size_t row = 2000 + gen.Pick(8000); row > 0; --row) {
+            md += '|';
+
+            for (size_t column = 0; column < columns; ++column) {
+                md += ' ';
+                gen.AppendSentence(md, 1 + gen.Pick(3), 10);
+                md += gen.Chance(2) ? " \\| |" : " |";
+            }
+
+            md += '\n';
+        }
+
+        md += '\n';
+    }
+
+    return md;
+}
+
+std::string generateCode(size_t size) {
+    TextGenerator gen(4);
+    const char* const languages[] = {"cpp", "python", "sh", "json", ""};
+    const char* const statements[] = {
+        "int count = 0; // the number of lines",
+        "for (size_t i = 0; i < size; ++i) { total += values[i] * 2; }",
+        "if (line.empty() && !isFinished) return \"<empty>\";",
+        "def parse(self, text): return [x for x in text.split() if x]",
+        "echo \"$HOME\" | grep -v '#' > /tmp/out.txt",
+        "{\"name\": \"maddy\", \"size\": 1024, \"enabled\": true}",
+        "#include <string>",
+        "    std::cout << value << std::endl;",
+    };
+
+    std::string md;
+
+    while (md.size() < size) {
+        gen.AppendSentence(md, 10 + gen.Pick(10), 10);
+        md += "\n\n```";
+        md += languages[gen.Pick(5)];
+        md += '\n';
+
+        for (size_t line = 20 + gen.Pick(60); line > 0; --line) {
+            md += statements[gen.Pick(8)];
+            md += '\n';
+        }
+
+        md += "```\n\n";
+    }
+
+    return md;
+}
+
+std::string generatePathologicalEmphasis(size_t size) {
+    TextGenerator gen(5);
+    const char markup[] = "*_~`[]()!<>\"a ";
+    std::string md;
+
+    while (md.size() < size) {
+        switch (gen.Pick(4)) {
+        case 0:
+            // random markup soup
+            for (size_t i = 200 + gen.Pick(1800); i > 0; --i) {
+                md += markup[gen.Pick(sizeof(markup) - 1)];
+            }
+            break;
+        case 1:
+            // long runs of unclosed delimiters
+            md += std::string(500 + gen.Pick(1500), "*_~"[gen.Pick(3)]);
+            md += " text";
+            break;
+        case 2:
+            for (size_t i = 100 + gen.Pick(400); i > 0; --i) {
+                md += "![[";
+            }
+            md += "](x";
+            break;
+        default:
+            for (size_t i = 100 + gen.Pick(400); i > 0; --i) {
+                md += "**a _b `c ";
+            }
+            break;
+        }
+
+        md += "\n\n";
+    }
+
+    return md;
+}
+
+// one line like a minified dump: words, markup, cells and base64 blobs
+std::string generateLongLine(size_t size) {
+    TextGenerator gen(6);
+    const char base64[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    std::string md;
+    md.reserve(size + 256);
+
+    while (md.size() < size) {
+        if (gen.Chance(10)) {
+            for (size_t i = 64 + gen.Pick(192); i > 0; --i) {
+                md += base64[gen.Pick(64)];
+            }
+            md += ' ';
+        } else {
+            gen.AppendSentence(md, 8, 15);
+            md += gen.Chance(30) ? " | " : " ";
+        }
+    }
+
+    md.resize(size);
+    return md;
+}
+
+// ---------------------------------------------------------------------------
+
+size_t countLines(const std::string& text) {
+    const size_t breaks =
+        static_cast<size_t>(std::count(text.begin(), text.end(), '\n'));
+    return breaks + (!text.empty() && text.back() != '\n' ? 1 : 0);
+}
+
+bool readFile(const std::string& path, std::string& content) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    content.assign(std::istreambuf_iterator<char>(file),
+                   std::istreambuf_iterator<char>());
+    maddy::InputNormalizer::Normalize(content);
+    return true;
+}
+
+std::shared_ptr<maddy::ParserConfig> makeConfig(uint32_t enabledParsers) {
+    auto config = std::make_shared<maddy::ParserConfig>();
+    config->enabledParsers = enabledParsers;
+    // threads are measured in their own scenarios
+    config->parallelParsingThreshold = 0;
+    return config;
+}
+
+const char* simdLevel() {
+#if defined(MADDY_SIMD_AVX2)
+    return "avx2";
+#elif defined(MADDY_SIMD_SSE2)
+    return "sse2";
+#else
+    return "none";
+#endif
+}
+
+class Benchmark {
+public:
+    explicit Benchmark(const Options& options) : options(options) {}
+
+    bool IsSelected(const std::string& scenario) const {
+        return options.filter.empty() ||
+               scenario.find(options.filter) != std::string::npos;
+    }
+
+    // Times `run` (which returns the size of its output) and keeps the best
+    // run. Small inputs are parsed several times per timed run, large ones
+    // stop repeating after about 10 seconds.
+    void Measure(const std::string& scenario, const std::string& preset,
+                 size_t threads, size_t bytes, size_t lines,
+                 const std::function<size_t()>& run) {
+        const size_t batch = std::max<size_t>(1, MiB / std::max<size_t>(bytes, 1));
+        Result result = {scenario, preset, threads, bytes, lines, 0, 0, 1e300};
+        double total = 0;
+
+        while (result.runs < options.repeat && (result.runs == 0 || total < 10)) {
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < batch; ++i) {
+                result.outputBytes = run();
+            }
+            const std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - start;
+
+            total += elapsed.count();
+            result.seconds = std::min(result.seconds, elapsed.count() / batch);
+            ++result.runs;
+        }
+
+        const double lineCount = static_cast<double>(std::max<size_t>(lines, 1));
+        std::printf("%-26s %-12s %3zu %10.1f MB/s %14.1f lines/s %10.1f ns/line\n",
+                    scenario.c_str(), preset.c_str(), threads,
+                    bytes / result.seconds / 1e6, lineCount / result.seconds,
+                    result.seconds * 1e9 / lineCount);
+        std::fflush(stdout);
+        results.push_back(result);
+    }
+
+    // every preset on one document
+    void Run(const std::string& scenario, const std::string& markdown,
+             const std::vector<Preset>& presets) {
+        if (!IsSelected(scenario)) {
+            return;
+        }
+
+        const size_t lines = countLines(markdown);
+
+        for (const Preset& preset : presets) {
+            const maddy::Parser parser(preset.config);
+            Measure(scenario, preset.name, 1, markdown.size(), lines,
+                    [&parser, &markdown]() { return parser.Parse(markdown).size(); });
+        }
+    }
+
+    // the first-byte block classification alone, without any parser
+    void RunClassifier(const std::string& markdown) {
+        if (!IsSelected("block-classification")) {
+            return;
+        }
+
+        std::vector<std::string> lines;
+        for (size_t begin = 0; begin < markdown.size();) {
+            size_t end = markdown.find('\n', begin);
+            end = end == std::string::npos ? markdown.size() : end;
+            lines.push_back(markdown.substr(begin, end - begin));
+            begin = end + 1;
+        }
+
+        Measure("block-classification", "classifier", 1, markdown.size(),
+                lines.size(), [&lines]() {
+                    size_t candidates = 0;
+                    for (const std::string& line : lines) {
+                        candidates += maddy::BlockClassifier::GetCandidates(line) != 0;
+                    }
+                    return candidates;
+                });
+    }
+
+    // Stress test: many threads share one parser from a ParserPool and parse
+    // the same document several times per timed run. Every single output is
+    // compared with the output of an independent parser on one thread, the
+    // benchmark fails on any difference.
+    void RunSharedParser(const std::string& markdown, size_t threadCount,
+                         const std::vector<Preset>& presets) {
+        if (!IsSelected("shared-parser")) {
+            return;
+        }
+
+        const size_t parsesPerThread = 4;
+        maddy::ParserPool pool;
+
+        for (const Preset& preset : presets) {
+            const std::shared_ptr<const maddy::Parser> parser = pool.Get(preset.config);
+            const std::string expected = maddy::Parser(preset.config).Parse(markdown);
+            const size_t parseCount = threadCount * parsesPerThread;
+
+            Measure("shared-parser", preset.name, threadCount,
+                    markdown.size() * parseCount, countLines(markdown) * parseCount,
+                    [this, &parser, &markdown, &expected, threadCount, parseCount]() {
+                        std::vector<size_t> mismatchCounts(threadCount, 0);
+                        std::vector<std::thread> workers;
+
+                        for (size_t i = 0; i < threadCount; ++i) {
+                            workers.emplace_back([&, i]() {
+                                for (size_t run = 0; run < parsesPerThread; ++run) {
+                                    if (parser->Parse(markdown) != expected) {
+                                        ++mismatchCounts[i];
+                                    }
+                                }
+                            });
+                        }
+
+                        for (std::thread& worker : workers) {
+                            worker.join();
+                        }
+
+                        for (const size_t count : mismatchCounts) {
+                            if (count > 0) {
+                                AddMismatch("shared-parser");
+                            }
+                        }
+
+                        return expected.size() * parseCount;
+                    });
+        }
+    }
+
+    // one document split into chunks, which are parsed on several threads
+    void RunParallelParse(const std::string& markdown, size_t threadCount) {
+        if (!IsSelected("parallel-parse")) {
+            return;
+        }
+
+        auto config = makeConfig(maddy::types::DEFAULT);
+        config->parallelParsingThreshold = 1;
+        config->parallelParsingThreadCount = threadCount;
+        const maddy::Parser parser(config);
+        const maddy::Parser reference(makeConfig(maddy::types::DEFAULT));
+        const std::string expected = reference.Parse(markdown);
+
+        Measure("parallel-parse", "default", threadCount, markdown.size(),
+                countLines(markdown), [this, &parser, &markdown, &expected]() {
+                    const std::string html = parser.Parse(markdown);
+                    if (html != expected) {
+                        AddMismatch("parallel-parse");
+                    }
+                    return html.size();
+                });
+    }
+
+    // ParseTree and the HtmlRenderer have to write the same HTML as Parse
+    void RunDocumentTree(const std::string& scenario, const std::string& markdown,
+                         const std::vector<Preset>& presets) {
+        const std::string name = "tree:" + scenario;
+        if (!IsSelected(name)) {
+            return;
+        }
+
+        const size_t lines = countLines(markdown);
+
+        for (const Preset& preset : presets) {
+            const maddy::Parser parser(preset.config);
+            const std::string expected = parser.Parse(markdown);
+            maddy::DocumentTree tree;
+
+            Measure(name, preset.name, 1, markdown.size(), lines,
+                    [this, &name, &parser, &markdown, &expected, &tree]() {
+                        std::string html;
+                        maddy::StringOutputSink sink(html);
+
+                        parser.ParseTree(markdown, tree);
+                        maddy::HtmlRenderer(parser, markdown.data()).Render(tree, sink);
+                        if (html != expected) {
+                            AddMismatch(name);
+                        }
+                        return html.size();
+                    });
+
+            std::printf("%-26s %-12s     %zu nodes, %.1f%% of the HTML size\n",
+                        name.c_str(), preset.name.c_str(), tree.GetNodes().size(),
+                        100.0 * tree.GetNodes().size() * sizeof(maddy::DocumentNode) /
+                            std::max<size_t>(expected.size(), 1));
+        }
+    }
+
+    void AddMismatch(const std::string& scenario) {
+        if (std::find(mismatches.begin(), mismatches.end(), scenario) ==
+            mismatches.end()) {
+            mismatches.push_back(scenario);
+        }
+    }
+
+    const std::vector<std::string>& GetMismatches() const { return mismatches; }
+
+    bool WriteJson(const std::string& path) const {
+        std::ofstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            return false;
+        }
+
+        file << "{\n"
+             << "  \"maddy_version\": \"" << maddy::Parser::version() << "\",\n"
+             << "  \"simd\": \"" << simdLevel() << "\",\n"
+             << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+#ifdef NDEBUG
+             << "  \"optimized\": true,\n"
+#else
+             << "  \"optimized\": false,\n"
+#endif
+             << "  \"results\": [";
+
+        char number[64];
+
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Result& result = results[i];
+            const double lines = static_cast<double>(std::max<size_t>(result.lines, 1));
+
+            file << (i > 0 ? ",\n" : "\n")
+                 << "    {\"scenario\": " << quote(result.scenario)
+                 << ", \"preset\": " << quote(result.preset)
+                 << ", \"threads\": " << result.threads
+                 << ", \"bytes\": " << result.bytes
+                 << ", \"lines\": " << result.lines
+                 << ", \"output_bytes\": " << result.outputBytes
+                 << ", \"runs\": " << result.runs;
+            std::snprintf(number, sizeof(number), "%.9g", result.seconds);
+            file << ", \"seconds\": " << number;
+            std::snprintf(number, sizeof(number), "%.3f",
+                          result.bytes / result.seconds / 1e6);
+            file << ", \"mb_per_s\": " << number;
+            std::snprintf(number, sizeof(number), "%.1f", lines / result.seconds);
+            file << ", \"lines_per_s\": " << number;
+            std::snprintf(number, sizeof(number), "%.3f", result.seconds * 1e9 / lines);
+            file << ", \"ns_per_line\": " << number << "}";
+        }
+
+        file << "\n  ]\n}\n";
+        return file.good();
+    }
+
+private:
+    const Options& options;
+    std::vector<Result> results;
+    std::vector<std::string> mismatches;
+
+    static std::string quote(const std::string& text) {
+        std::string quoted = "\"";
+
+        for (const char c : text) {
+            if (c == '"' || c == '\\') {
+                quoted += '\\';
+                quoted += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                quoted += escaped;
+            } else {
+                quoted += c;
+            }
+        }
+
+        return quoted + '"';
+    }
+};
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--quick") {
+            options.quick = true;
+            options.corpusSize = MiB;
+            options.repeat = 1;
+        } else if (arg == "--size" && hasValue) {
+            options.corpusSize = std::strtoul(argv[++i], nullptr, 10) * MiB;
+        } else if (arg == "--repeat" && hasValue) {
+            options.repeat = std::max<size_t>(1, std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = std::strtoul(argv[++i], nullptr, 10);
+        } else if (arg == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        } else if (arg == "--json" && hasValue) {
+            options.jsonPath = argv[++i];
+        } else if (arg.compare(0, 2, "--") == 0) {
+            return false;
+        } else {
+            options.files.push_back(arg);
+        }
+    }
+
+    return options.corpusSize > 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        std::cerr << "Usage: maddy_bench [--quick] [--size MiB] [--repeat N] "
+                     "[--threads N] [--filter TEXT] [--json FILE] [file.md ...]"
+                  << std::endl;
+        return 1;
+    }
+
+#ifndef NDEBUG
+    std::cerr << "Warning: not an optimized build, configure with "
+                 "-DCMAKE_BUILD_TYPE=Release" << std::endl;
+#endif
+
+    if (options.files.empty()) {
+        // the sample document of the repository
+        std::ifstream local("test.md");
+        options.files.push_back(local.is_open()
+                                    ? std::string("test.md")
+                                    : std::string(MADDY_BENCH_SOURCE_DIR "/test.md"));
+    }
+
+    const size_t threadCount = options.threads > 0
+                                   ? options.threads
+                                   : std::max(2u, std::thread::hardware_concurrency());
+
+    // DefaultParser, HighlightedParser and AllParser are specialized at
+    // compile time, any other config runs with the runtime feature checks
+    const std::vector<Preset> presets = {
+        {"default", makeConfig(maddy::types::DEFAULT)},
+        {"all", makeConfig(maddy::types::ALL)},
+        {"highlight", makeConfig(maddy::types::HIGHLIGHTED)},
+        {"runtime", makeConfig(maddy::types::DEFAULT &
+                               ~maddy::types::HORIZONTAL_LINE_PARSER)},
+    };
+
+    std::printf("maddy %s, SIMD %s, %zu MiB per synthetic scenario\n\n",
+                maddy::Parser::version().c_str(), simdLevel(), options.corpusSize / MiB);
+    std::printf("%-26s %-12s %3s\n", "scenario", "preset", "thr");
+
+    Benchmark benchmark(options);
+    const std::vector<std::pair<std::string, std::string>> corpora = {
+        {"prose", generateProse(options.corpusSize)},
+        {"deep-lists", generateDeepLists(options.corpusSize)},
+        // a line should cost the same on any level of a list
+        {"flat-list", generateListOutline(options.corpusSize, 1)},
+        {"deep-outline", generateListOutline(options.corpusSize, 40)},
+        {"huge-tables", generateTables(options.corpusSize)},
+        {"code-heavy", generateCode(options.corpusSize)},
+        {"pathological-emphasis", generatePathologicalEmphasis(options.corpusSize)},
+    };
+    const std::string& prose = corpora[0].second;
+
+    for (const auto& corpus : corpora) {
+        benchmark.Run(corpus.first, corpus.second, presets);
+    }
+
+    const size_t longLineSizes[] = {1, 10, 100};
+    for (const size_t size : longLineSizes) {
+        const std::string name = "long-line-" + std::to_string(size) + "mb";
+        if ((options.quick && size > 1) || !benchmark.IsSelected(name)) {
+            continue;
+        }
+        benchmark.Run(name, generateLongLine(size * MiB), presets);
+    }
+
+    for (const std::string& path : options.files) {
+        std::string content;
+        if (!readFile(path, content)) {
+            std::cerr << "Error: Could not open file " << path << std::endl;
+            return 1;
+        }
+        benchmark.Run("file:" + path, content, presets);
+        benchmark.RunDocumentTree("file:" + path, content, presets);
+    }
+
+    for (const auto& corpus : corpora) {
+        benchmark.RunDocumentTree(corpus.first, corpus.second, presets);
+    }
+
+    // lines, which exceed a limit, are escaped text in the tree as well
+    auto shortLines = makeConfig(maddy::types::DEFAULT);
+    shortLines->maxLineLength = 10;
+    auto smallOutput = makeConfig(maddy::types::DEFAULT);
+    smallOutput->maxOutputSize = 64 * 1024;
+    const std::vector<Preset> limitPresets = {
+        {"short-lines", shortLines},
+        {"small-output", smallOutput},
+    };
+
+    benchmark.RunDocumentTree("degraded-lines",
+                              "# head\n\nthis line is far too long\n\npara\n",
+                              limitPresets);
+    benchmark.RunDocumentTree("degraded-prose", prose, limitPresets);
+
+    benchmark.RunClassifier(prose);
+    // a bit of every corpus, so that all block parsers run on every thread
+    std::string mixed;
+    for (const auto& corpus : corpora) {
+        mixed.append(corpus.second, 0, std::min<size_t>(corpus.second.size(), 256 * 1024));
+        mixed += "\n\n";
+    }
+    benchmark.RunSharedParser(mixed, threadCount, presets);
+    benchmark.RunParallelParse(prose, threadCount);
+
+    if (!benchmark.WriteJson(options.jsonPath)) {
+        std::cerr << "Error: Could not write " << options.jsonPath << std::endl;
+        return 1;
+    }
+
+    std::printf("\nResults written to %s\n", options.jsonPath.c_str());
+
+    if (!benchmark.GetMismatches().empty()) {
+        for (const std::string& scenario : benchmark.GetMismatches()) {
+            std::cerr << "Error: " << scenario
+                      << " differs from the single threaded Parse output" << std::endl;
+        }
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,7 +1,7 @@
 #include <fstream>
 #include <iostream>
 #include <string>
-#include <sstream>
+#include "maddy/inputnormalizer.h"
 #include "maddy/parser.h"  
 #include "webview.h"       
 
@@ -11,20 +11,37 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    std::ifstream file(argv[1]);
+    std::ifstream file(argv[1], std::ios::binary);
     if (!file.is_open()) {
         std::cerr << "Error: Could not open file " << argv[1] << std::endl;
         return 1;
     }
     
-    std::string md_content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    // Read a file of known size at once
+    std::string md_content;
+    std::streamoff size = -1;
+    if (file.seekg(0, std::ios::end)) {
+        size = file.tellg();
+    }
+    file.clear();
+    file.seekg(0, std::ios::beg);
+    file.clear();
+    if (size > 0 && static_cast<unsigned long long>(size) <= md_content.max_size()) {
+        md_content.resize(static_cast<size_t>(size));
+        file.read(&md_content[0], md_content.size());
+        md_content.resize(static_cast<size_t>(file.gcount()));
+        file.clear();
+    }
+    
+    // Unknown size (pipe, FIFO) or a file, which grew: read the rest in chunks
+    char buf[1 << 15];
+    while (file.read(buf, sizeof(buf)) || file.gcount() > 0) {
+        md_content.append(buf, static_cast<size_t>(file.gcount()));
+    }
     file.close();
 
-    // Parse Markdown to HTML
-    std::shared_ptr<maddy::ParserConfig> config = std::make_shared<maddy::ParserConfig>();
-    std::stringstream md_stream(md_content);
-    maddy::Parser parser(config);
-    std::string html = parser.Parse(md_stream);
+    // Strip the BOM and turn CRLF/CR into LF; invalid UTF-8 is shown as is
+    maddy::InputNormalizer::Normalize(md_content);
 
     // Minimal wrapper
     std::string full_html = R"(
@@ -69,6 +86,14 @@ int main(int argc, char* argv[]) {
                     background-color: transparent;
                     padding: 0;
                 }
+                .hl-keyword, .hl-section { color: #d73a49; }
+                .hl-type, .hl-key { color: #6f42c1; }
+                .hl-literal, .hl-number, .hl-variable { color: #005cc5; }
+                .hl-string { color: #032f62; }
+                .hl-comment { color: #6a737d; font-style: italic; }
+                .hl-meta, .hl-heading { color: #e36209; }
+                .hl-addition { color: #22863a; background-color: #f0fff4; }
+                .hl-deletion { color: #b31d28; background-color: #ffeef0; }
                 blockquote {
                     margin: 0;
                     padding: 0 1em;
@@ -101,7 +126,19 @@ int main(int argc, char* argv[]) {
                 }
             </style>
         </head>
-        <body>)" + html + R"(</body>
+        <body>)";
+
+    // Parse Markdown to HTML straight into the page
+    // A hostile file degrades to plain text instead of freezing the viewer
+    std::shared_ptr<maddy::ParserConfig> config = std::make_shared<maddy::ParserConfig>();
+    config->maxNestingDepth = 64;
+    config->timeLimit = 5000;
+    config->enabledParsers = maddy::types::HIGHLIGHTED;
+    maddy::Parser parser(config);
+    maddy::StringOutputSink sink(full_html);
+    parser.Parse(md_content.data(), md_content.size(), sink);
+
+    full_html += R"(</body>
         </html>
     )";
 
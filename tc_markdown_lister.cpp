@@ -11,7 +11,9 @@
 #include <wrl.h>
 #include <comdef.h>
 #include "WebView2.h"
+#include "include/maddy/inputnormalizer.h"
 #include "include/maddy/parser.h"
+#include "include/maddy/parserpool.h"
 
 using Microsoft::WRL::Callback;
 using Microsoft::WRL::ComPtr;
@@ -52,37 +54,6 @@ void PrepareWebView2UserData() {
     }
 }
 
-// Detect if data contains UTF-8 BOM or is valid UTF-8
-bool IsUtf8(const std::string& data) {
-    // Check for UTF-8 BOM
-    if (data.size() >= 3 && (unsigned char)data[0] == 0xEF && 
-        (unsigned char)data[1] == 0xBB && (unsigned char)data[2] == 0xBF) {
-        return true;
-    }
-    
-    // Simple UTF-8 validation heuristic
-    const unsigned char* bytes = (const unsigned char*)data.c_str();
-    size_t len = data.length();
-    
-    for (size_t i = 0; i < len; ) {
-        if (bytes[i] < 0x80) {
-            i++; // ASCII
-        } else if ((bytes[i] & 0xE0) == 0xC0) {
-            if (i + 1 >= len || (bytes[i + 1] & 0xC0) != 0x80) return false;
-            i += 2; // 2-byte UTF-8
-        } else if ((bytes[i] & 0xF0) == 0xE0) {
-            if (i + 2 >= len || (bytes[i + 1] & 0xC0) != 0x80 || (bytes[i + 2] & 0xC0) != 0x80) return false;
-            i += 3; // 3-byte UTF-8
-        } else if ((bytes[i] & 0xF8) == 0xF0) {
-            if (i + 3 >= len || (bytes[i + 1] & 0xC0) != 0x80 || (bytes[i + 2] & 0xC0) != 0x80 || (bytes[i + 3] & 0xC0) != 0x80) return false;
-            i += 4; // 4-byte UTF-8
-        } else {
-            return false; // Invalid UTF-8
-        }
-    }
-    return true;
-}
-
 // Convert ANSI (system codepage) to UTF-8
 std::string AnsiToUtf8(const std::string& ansi) {
     if (ansi.empty()) return std::string();
@@ -108,7 +79,21 @@ std::string ReadAllUtf8(const std::wstring& wpath) {
         return {};
     }
     
+    // Read a file of known size at once, 64-bit offsets for files over 2 GB
     std::string data;
+    __int64 size = -1;
+    if (_fseeki64(f, 0, SEEK_END) == 0) {
+        size = _ftelli64(f);
+    }
+    if (_fseeki64(f, 0, SEEK_SET) != 0) {
+        rewind(f);
+    }
+    if (size > 0 && (unsigned __int64)size <= data.max_size()) {
+        data.resize((size_t)size);
+        data.resize(fread(&data[0], 1, data.size(), f));
+    }
+    
+    // Unknown size (ftell failed) or a file, which grew: read the rest in chunks
     char buf[1 << 15];
     size_t n;
     while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
@@ -118,14 +103,13 @@ std::string ReadAllUtf8(const std::wstring& wpath) {
     
     DebugLog("ReadAllUtf8: Read " + std::to_string(data.length()) + " bytes");
     
-    // Check if the data is already UTF-8
-    if (IsUtf8(data)) {
-        // Remove UTF-8 BOM if present
-        if (data.size() >= 3 && (unsigned char)data[0] == 0xEF && 
-            (unsigned char)data[1] == 0xBB && (unsigned char)data[2] == 0xBF) {
-            data = data.substr(3);
-            DebugLog("ReadAllUtf8: Removed UTF-8 BOM");
-        }
+    // Strip the BOM, turn CRLF/CR into LF and validate UTF-8 in one pass
+    maddy::InputNormalizer::Result input = maddy::InputNormalizer::Normalize(data);
+    if (input.hasByteOrderMark) {
+        DebugLog("ReadAllUtf8: Removed UTF-8 BOM");
+    }
+    
+    if (input.hasByteOrderMark || input.isValidUtf8) {
         DebugLog("ReadAllUtf8: File detected as UTF-8");
         return data;
     } else {
@@ -233,6 +217,14 @@ const char* HTML_TEMPLATE = R"(
             background-color: transparent;
             padding: 0;
         }
+        .hl-keyword, .hl-section { color: #d73a49; }
+        .hl-type, .hl-key { color: #6f42c1; }
+        .hl-literal, .hl-number, .hl-variable { color: #005cc5; }
+        .hl-string { color: #032f62; }
+        .hl-comment { color: #6a737d; font-style: italic; }
+        .hl-meta, .hl-heading { color: #e36209; }
+        .hl-addition { color: #22863a; background-color: #f0fff4; }
+        .hl-deletion { color: #b31d28; background-color: #ffeef0; }
         blockquote {
             margin: 0;
             padding: 0 1em;
@@ -276,6 +268,14 @@ const char* HTML_TEMPLATE = R"(
         .dark pre {
             background-color: #161b22;
         }
+        .dark .hl-keyword, .dark .hl-section { color: #ff7b72; }
+        .dark .hl-type, .dark .hl-key { color: #d2a8ff; }
+        .dark .hl-literal, .dark .hl-number, .dark .hl-variable { color: #79c0ff; }
+        .dark .hl-string { color: #a5d6ff; }
+        .dark .hl-comment { color: #8b949e; }
+        .dark .hl-meta, .dark .hl-heading { color: #ffa657; }
+        .dark .hl-addition { color: #aff5b4; background-color: #033a16; }
+        .dark .hl-deletion { color: #ffdcd7; background-color: #67060c; }
         .dark table th, .dark table td {
             border-color: #30363d;
         }
@@ -315,19 +315,31 @@ std::string ConvertMarkdownToHtml(const std::wstring& wfilePath) {
         
         DebugLog("ConvertMarkdownToHtml: Read " + std::to_string(mdContent.length()) + " bytes");
         
-        // Parse Markdown to HTML
-        std::shared_ptr<maddy::ParserConfig> config = std::make_shared<maddy::ParserConfig>();
-        std::stringstream mdStream(mdContent);
-        maddy::Parser parser(config);
-        std::string html = parser.Parse(mdStream);
+        // Parse Markdown to HTML straight into the template
+        std::string result;
+        const char* contentPos = strstr(HTML_TEMPLATE, "%CONTENT%");
+        size_t prefixLength = contentPos ? (size_t)(contentPos - HTML_TEMPLATE) : strlen(HTML_TEMPLATE);
+        result.reserve(strlen(HTML_TEMPLATE) + mdContent.length() * 2);
+        result.append(HTML_TEMPLATE, prefixLength);
+
+        // One warm parser for all files, it can be used from any thread.
+        // A hostile file degrades to plain text instead of blocking Lister.
+        static const std::shared_ptr<maddy::ParserConfig> parserConfig = []() {
+            std::shared_ptr<maddy::ParserConfig> config = std::make_shared<maddy::ParserConfig>();
+            config->maxNestingDepth = 64;
+            config->timeLimit = 5000;
+            config->enabledParsers = maddy::types::HIGHLIGHTED;
+            return config;
+        }();
+        static maddy::ParserPool parserPool;
+        std::shared_ptr<const maddy::Parser> parser = parserPool.Get(parserConfig);
+        maddy::StringOutputSink sink(result);
+        parser->Parse(mdContent.data(), mdContent.size(), sink);
         
-        DebugLog("ConvertMarkdownToHtml: Parsed HTML length: " + std::to_string(html.length()));
+        DebugLog("ConvertMarkdownToHtml: Parsed HTML length: " + std::to_string(result.length() - prefixLength));
         
-        // Replace placeholder in template
-        std::string result = HTML_TEMPLATE;
-        size_t pos = result.find("%CONTENT%");
-        if (pos != std::string::npos) {
-            result.replace(pos, 9, html);
+        if (contentPos) {
+            result.append(contentPos + 9);
         }
         
         DebugLog("ConvertMarkdownToHtml: Final HTML length: " + std::to_string(result.length()));